@@ -19,6 +19,11 @@
 
 #include "update_debug_token.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 
 DebugTokenInstallStatus
@@ -49,8 +54,10 @@ DebugTokenInstallStatus
             static_cast<int>(CommonErrorCodes::TokenParseFailure));
         return status;
     }
+    size_t handled = 0;
     for (auto& device : devices)
     {
+        reportProgress(handled++, devices.size());
         if (tokens.find(device.second) != tokens.end())
         {
             queryStatus = queryDebugToken(device.first);
@@ -126,6 +133,7 @@ DebugTokenInstallStatus
             }
         }
     }
+    reportProgress(devices.size(), devices.size());
     return status;
 }
 
@@ -144,8 +152,10 @@ int UpdateDebugToken::eraseDebugToken()
             static_cast<int>(CommonErrorCodes::MCTPDiscoveryFailed));
         return status;
     }
+    size_t handled = 0;
     for (auto& [uuid, mctpEidInfo] : mctpInfo)
     {
+        reportProgress(handled++, mctpInfo.size());
         queryStatus = queryDebugToken(mctpEidInfo.eid);
         if(queryStatus < 0 || queryStatus ==
             static_cast<int>(DebugTokenQueryErrorCodes::DebugTokenNotInstalled))
@@ -193,6 +203,7 @@ int UpdateDebugToken::eraseDebugToken()
                                  .c_str());
         }
     }
+    reportProgress(mctpInfo.size(), mctpInfo.size());
     return status;
 }
 
@@ -962,4 +973,26 @@ void UpdateDebugToken::createMessageRegistryResourceErrors(
                         entry("DeviceName: %s", deviceName.c_str()));
     }
     return;
-}
\ No newline at end of file
+}
+
+void UpdateDebugToken::reportProgress(size_t done, size_t total)
+{
+    const char* fifo = std::getenv("STATUS_FIFO");
+    if (fifo == nullptr)
+    {
+        return;
+    }
+    // Without a reader the open fails instead of blocking the tool
+    int fd = open(fifo, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+    auto line = fmt::format("PROGRESS {} {}\n", done, total);
+    if (write(fd, line.data(), line.size()) < 0)
+    {
+        log<level::DEBUG>("Unable to report progress",
+                          entry("ERROR=%s", std::strerror(errno)));
+    }
+    close(fd);
+}
@@ -486,4 +486,15 @@ class UpdateDebugToken : public TokenUtility
      */
     void createLog(const std::string& messageID,
                    std::map<std::string, std::string>& addData, Level& level);
+    /**
+     * @brief report progress to code-manager through the status FIFO the
+     *        update unit passes in STATUS_FIFO, nothing is reported when
+     *        nobody reads it
+     *
+     * @param[in] done - devices handled
+     * @param[in] total - devices to handle
+     *
+     * @return void
+     */
+    void reportProgress(size_t done, size_t total);
 };
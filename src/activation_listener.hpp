@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include "activation_trace.hpp"
+
+#include <chrono>
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include <sdbusplus/bus.hpp>
@@ -43,6 +48,29 @@ struct TargetFilter
     std::vector<std::string> targets;
 };
 
+/**
+ * @brief Asset details of a device, read in one pass and cached by the item
+ * updater.
+ *
+ */
+struct DeviceSnapshot
+{
+    /** @brief Version, model and manufacturer reported by the device */
+    std::string version;
+    std::string model;
+    std::string manufacturer;
+    bool deviceRead = false;
+
+    /** @brief Present, Model and Manufacturer of the inventory object */
+    bool present = false;
+    std::string inventoryModel;
+    std::string inventoryManufacturer;
+    bool inventoryRead = false;
+
+    /** @brief Digest of the image last flashed to the device successfully */
+    std::string flashedDigest;
+};
+
 class ActivationListener
 {
   public:
@@ -75,6 +103,15 @@ class ItemUpdaterUtils
      */
     virtual std::vector<std::string> getItemUpdaterInventoryPaths() = 0;
 
+    /**
+     * @brief Get the Item Updater Inventory Paths object without blocking
+     * the event loop
+     *
+     * @param callback - gets an empty list on failure
+     */
+    virtual void getItemUpdaterInventoryPathsAsync(
+        std::function<void(std::vector<std::string>)> callback) = 0;
+
     /**
      * @brief Get the Service Name object
      *
@@ -116,6 +153,64 @@ class ItemUpdaterUtils
      */
     virtual void readExistingFirmWare() = 0;
 
+    /**
+     * @brief Reads the firmware of one device again and reconciles its
+     * software object, the other devices are not read
+     *
+     * @param inventoryPath
+     */
+    virtual void refreshDevice(const std::string& inventoryPath) = 0;
+
+    /**
+     * @brief Get the cached snapshot of the device with the device details
+     * read
+     *
+     * @param inventoryPath
+     * @return const DeviceSnapshot&
+     */
+    virtual const DeviceSnapshot&
+        getDeviceSnapshot(const std::string& inventoryPath) = 0;
+
+    /**
+     * @brief Drops the device details of the snapshot so that they are read
+     * again on next use
+     *
+     * @param inventoryPath
+     */
+    virtual void invalidateDeviceSnapshot(const std::string& inventoryPath) = 0;
+
+    /**
+     * @brief Records the digest of the image flashed to the device, empty to
+     * forget it
+     *
+     * @param inventoryPath
+     * @param digest
+     */
+    virtual void setFlashedDigest(const std::string& inventoryPath,
+                                  const std::string& digest) = 0;
+
+    /**
+     * @brief Get the cached snapshot of the device with the inventory asset
+     * properties read
+     *
+     * @param inventoryPath
+     * @return const DeviceSnapshot&
+     */
+    virtual const DeviceSnapshot&
+        getInventorySnapshot(const std::string& inventoryPath) = 0;
+
+    /**
+     * @brief Get the cached snapshot of the device, the inventory asset
+     * properties are read without blocking the event loop when not known yet
+     *
+     * @param inventoryPath
+     * @param callback - inventoryRead is false if the properties could not be
+     * read
+     */
+    virtual void getInventorySnapshotAsync(
+        const std::string& inventoryPath,
+        std::function<void(const DeviceSnapshot&)> callback) = 0;
+
     /**
      * @brief Get D-Bus service name
      *
@@ -142,6 +237,47 @@ class ItemUpdaterUtils
      */
     virtual uint32_t getTimeout() = 0;
 
+    /**
+     * @brief Get the update timeout derived from the durations of the last
+     *        successful flashes of the same device model and image size,
+     *        never more than getTimeout()
+     *
+     * @param inventoryPath
+     * @param imageSize - in bytes
+     * @return uint32_t
+     */
+    virtual uint32_t getAdaptiveTimeout(const std::string& inventoryPath,
+                                        uintmax_t imageSize) = 0;
+
+    /**
+     * @brief Records the duration of a successful flash
+     *
+     * @param inventoryPath
+     * @param imageSize - in bytes
+     * @param duration
+     */
+    virtual void recordFlashDuration(const std::string& inventoryPath,
+                                     uintmax_t imageSize,
+                                     std::chrono::seconds duration) = 0;
+
+    /**
+     * @brief Get the maximum number of devices updated at the same time
+     *
+     * @return uint32_t
+     */
+    virtual uint32_t maxParallelUpdates() = 0;
+
+    /**
+     * @brief Get the bus the device is attached to. Devices on the same bus
+     *        are not updated at the same time.
+     *
+     * @param inventoryPath
+     * @return std::optional<uint32_t> - std::nullopt if the device does not
+     *         share a bus with other devices
+     */
+    virtual std::optional<uint32_t>
+        getDeviceBus(const std::string& inventoryPath) const = 0;
+
     /**
      * @brief method to check if inventory is supported, if inventory is not
      * supported then D-Bus calls to check compatibility can be ignored
@@ -149,4 +285,12 @@ class ItemUpdaterUtils
      * @return true - if inventory is supported else false
      */
     virtual bool inventorySupported() = 0;
+
+    /**
+     * @brief Get the trace recording the staging and activation steps
+     *
+     * @return nvidia::software::updater::ActivationTrace&
+     */
+    virtual nvidia::software::updater::ActivationTrace&
+        getActivationTrace() = 0;
 };
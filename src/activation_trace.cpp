@@ -0,0 +1,237 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "activation_trace.hpp"
+
+#include <phosphor-logging/log.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+using json = nlohmann::json;
+
+void ActivationTrace::record(const std::string& versionId,
+                             const std::string& device, TracePhase phase,
+                             Clock::time_point start, bool ok)
+{
+    if (spans.empty())
+    {
+        return;
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start);
+    auto wallStart = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()) -
+                     duration;
+    auto& span = spans[next];
+    span.versionId = versionId;
+    span.device = device;
+    span.phase = phase;
+    span.startUs = wallStart.count();
+    span.durationUs = duration.count();
+    span.ok = ok;
+    next = (next + 1) % spans.size();
+    count = std::min(count + 1, spans.size());
+}
+
+std::vector<TraceSpan> ActivationTrace::getSpans() const
+{
+    std::vector<TraceSpan> ordered;
+    if (count == 0)
+    {
+        return ordered;
+    }
+    ordered.reserve(count);
+    auto first = (next + spans.size() - count) % spans.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        ordered.push_back(spans[(first + i) % spans.size()]);
+    }
+    return ordered;
+}
+
+std::map<std::string, ActivationTrace::PhaseStats>
+    ActivationTrace::getStats() const
+{
+    std::map<std::string, PhaseStats> stats;
+    for (const auto& span : getSpans())
+    {
+        auto& [spanCount, total, max] = stats[toString(span.phase)];
+        spanCount++;
+        total += span.durationUs;
+        max = std::max(max, span.durationUs);
+    }
+    return stats;
+}
+
+bool ActivationTrace::dump(const std::filesystem::path& file) const
+{
+    json data;
+    auto items = json::array();
+    for (const auto& span : getSpans())
+    {
+        items.push_back({{"versionId", span.versionId},
+                         {"device", span.device},
+                         {"phase", toString(span.phase)},
+                         {"startUs", span.startUs},
+                         {"durationUs", span.durationUs},
+                         {"ok", span.ok}});
+    }
+    data["spans"] = items;
+    auto phases = json::object();
+    for (const auto& [phase, stats] : getStats())
+    {
+        const auto& [spanCount, total, max] = stats;
+        phases[phase] = {{"count", spanCount},
+                         {"totalUs", total},
+                         {"maxUs", max}};
+    }
+    data["phases"] = phases;
+
+    std::error_code ec;
+    std::filesystem::create_directories(file.parent_path(), ec);
+    std::ofstream out(file, std::ios::trunc);
+    out << data.dump(2);
+    if (!out.good())
+    {
+        log<level::ERR>("Unable to write activation trace",
+                        entry("FILE=%s", file.c_str()));
+        return false;
+    }
+    return true;
+}
+
+const char* ActivationTrace::toString(TracePhase phase)
+{
+    switch (phase)
+    {
+        case TracePhase::ImageStaging:
+            return "ImageStaging";
+        case TracePhase::CompatibilityCheck:
+            return "CompatibilityCheck";
+        case TracePhase::QueueWait:
+            return "QueueWait";
+        case TracePhase::UnitStart:
+            return "UnitStart";
+        case TracePhase::Flash:
+            return "Flash";
+        case TracePhase::Activation:
+            return "Activation";
+    }
+    return "Unknown";
+}
+
+const sdbusplus::vtable_t ActivationMetrics::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("Phases", "a{s(ttt)}",
+                                ActivationMetrics::getPhases,
+                                sdbusplus::vtable::property_::none),
+    sdbusplus::vtable::property("Spans", "a(sssttb)",
+                                ActivationMetrics::getSpans,
+                                sdbusplus::vtable::property_::none),
+    sdbusplus::vtable::method("Dump", "", "s", ActivationMetrics::callDump),
+    sdbusplus::vtable::end()};
+
+ActivationMetrics::ActivationMetrics(sdbusplus::bus::bus& bus,
+                                     const std::string& objPath,
+                                     const ActivationTrace& trace,
+                                     const std::filesystem::path& dumpFile) :
+    trace(trace), dumpFile(dumpFile),
+    serverInterface(bus, objPath.c_str(), interfaceName, vtable, this)
+{
+    serverInterface.emit_added();
+}
+
+int ActivationMetrics::getPhases(sd_bus* /* bus */, const char* /* path */,
+                                 const char* /* iface */,
+                                 const char* /* property */,
+                                 sd_bus_message* reply, void* context,
+                                 sd_bus_error* /* error */)
+{
+    auto metrics = static_cast<ActivationMetrics*>(context);
+    try
+    {
+        sdbusplus::message::message m(reply);
+        m.append(metrics->trace.getStats());
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Unable to reply activation phases",
+                        entry("ERROR=%s", e.what()));
+        return -EINVAL;
+    }
+    return 1;
+}
+
+int ActivationMetrics::getSpans(sd_bus* /* bus */, const char* /* path */,
+                                const char* /* iface */,
+                                const char* /* property */,
+                                sd_bus_message* reply, void* context,
+                                sd_bus_error* /* error */)
+{
+    auto metrics = static_cast<ActivationMetrics*>(context);
+    std::vector<std::tuple<std::string, std::string, std::string, uint64_t,
+                           uint64_t, bool>>
+        spans;
+    for (const auto& span : metrics->trace.getSpans())
+    {
+        spans.emplace_back(span.versionId, span.device,
+                           ActivationTrace::toString(span.phase), span.startUs,
+                           span.durationUs, span.ok);
+    }
+    try
+    {
+        sdbusplus::message::message m(reply);
+        m.append(spans);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Unable to reply activation spans",
+                        entry("ERROR=%s", e.what()));
+        return -EINVAL;
+    }
+    return 1;
+}
+
+int ActivationMetrics::callDump(sd_bus_message* msg, void* context,
+                                sd_bus_error* error)
+{
+    auto metrics = static_cast<ActivationMetrics*>(context);
+    if (!metrics->trace.dump(metrics->dumpFile))
+    {
+        sd_bus_error_set_const(
+            error, "xyz.openbmc_project.Common.Error.InternalFailure",
+            "Unable to write the activation trace");
+        return -EIO;
+    }
+    return sd_bus_reply_method_return(msg, "s", metrics->dumpFile.c_str());
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,207 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/**
+ * @brief Traced steps of image staging and activation
+ */
+enum class TracePhase
+{
+    /** @brief upload processed until the version object is Ready */
+    ImageStaging,
+    /** @brief device inventory read and compared with the image */
+    CompatibilityCheck,
+    /** @brief device waited for a free update slot */
+    QueueWait,
+    /** @brief StartUnit call of the update service */
+    UnitStart,
+    /** @brief update service ran until its job was removed or timed out */
+    Flash,
+    /** @brief whole activation, from request to Active or Failed */
+    Activation
+};
+
+/**
+ * @brief One traced step, times are in microseconds
+ */
+struct TraceSpan
+{
+    std::string versionId;
+    /** @brief inventory path, empty for steps not bound to a device */
+    std::string device;
+    TracePhase phase;
+    /** @brief wall clock start, since epoch */
+    uint64_t startUs;
+    uint64_t durationUs;
+    bool ok;
+};
+
+/** @class ActivationTrace
+ *
+ *  @brief Keeps the last spans of an item updater in a fixed size ring
+ *         buffer, the oldest span is overwritten when it is full. It is
+ *         only used from the event loop thread, so it takes no locks.
+ */
+class ActivationTrace
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief count, total and maximum duration of the spans of a phase */
+    using PhaseStats = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+    /**
+     * @brief Constructor
+     *
+     * @param capacity - spans kept, 0 disables tracing
+     */
+    explicit ActivationTrace(size_t capacity) : spans(capacity)
+    {}
+
+    /**
+     * @brief Records a span that started at start and ends now
+     *
+     * @param versionId
+     * @param device - inventory path, may be empty
+     * @param phase
+     * @param start - steady clock start
+     * @param ok - false if the step failed
+     */
+    void record(const std::string& versionId, const std::string& device,
+                TracePhase phase, Clock::time_point start, bool ok = true);
+
+    /**
+     * @brief Get the spans, oldest first
+     *
+     * @return std::vector<TraceSpan>
+     */
+    std::vector<TraceSpan> getSpans() const;
+
+    /**
+     * @brief Get the statistics of the buffered spans by phase name
+     *
+     * @return std::map<std::string, PhaseStats>
+     */
+    std::map<std::string, PhaseStats> getStats() const;
+
+    /**
+     * @brief Writes the spans and statistics as JSON
+     *
+     * @param file
+     * @return true if written
+     */
+    bool dump(const std::filesystem::path& file) const;
+
+    bool enabled() const
+    {
+        return !spans.empty();
+    }
+
+    /**
+     * @brief Get the name of a phase
+     *
+     * @param phase
+     * @return const char*
+     */
+    static const char* toString(TracePhase phase);
+
+  private:
+    std::vector<TraceSpan> spans;
+
+    /** @brief slot written next */
+    size_t next = 0;
+
+    /** @brief number of valid spans */
+    size_t count = 0;
+};
+
+/** @class ActivationMetrics
+ *
+ *  @brief Read-only com.Nvidia.Software.ActivationMetrics D-Bus interface
+ *         over an ActivationTrace. Properties are computed when read:
+ *         Phases a{s(ttt)} - span count, total and maximum microseconds
+ *                            by phase
+ *         Spans a(sssttb)  - version ID, device, phase, start, duration and
+ *                            result of the buffered spans, oldest first
+ *         Dump() -> s      - writes the trace as JSON, returns the file
+ */
+class ActivationMetrics
+{
+  public:
+    static constexpr auto interfaceName =
+        "com.Nvidia.Software.ActivationMetrics";
+
+    /**
+     * @brief Constructor
+     *
+     * @param bus
+     * @param objPath
+     * @param trace
+     * @param dumpFile - file written by Dump
+     */
+    ActivationMetrics(sdbusplus::bus::bus& bus, const std::string& objPath,
+                      const ActivationTrace& trace,
+                      const std::filesystem::path& dumpFile);
+
+  private:
+    static int getPhases(sd_bus* bus, const char* path, const char* iface,
+                         const char* property, sd_bus_message* reply,
+                         void* context, sd_bus_error* error);
+
+    static int getSpans(sd_bus* bus, const char* path, const char* iface,
+                        const char* property, sd_bus_message* reply,
+                        void* context, sd_bus_error* error);
+
+    static int callDump(sd_bus_message* msg, void* context,
+                        sd_bus_error* error);
+
+    static const sdbusplus::vtable_t vtable[];
+
+    const ActivationTrace& trace;
+
+    std::filesystem::path dumpFile;
+
+    sdbusplus::server::interface::interface serverInterface;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -47,6 +47,11 @@ namespace fs = std::filesystem;
 
 int BaseController::processImage(const std::string& imagePath)
 {
+    if (Watch::isStagingFile(imagePath))
+    {
+        // Not complete yet, processed when renamed into place
+        return 0;
+    }
     if (!fs::is_regular_file(imagePath))
     {
         // report and Log Event
@@ -63,7 +68,21 @@ int BaseController::processImage(const std::string& imagePath)
         log<level::ERR>("Error unable to read version from image file");
         return -1;
     }
-    if (abstractItemUpdater_->processImage(p) < 0)
+    auto itemUpdater = findItemUpdater(imagePath);
+    if (itemUpdater == nullptr)
+    {
+        log<level::ERR>("No updater for the image",
+                        entry("FILENAME=%s", imagePath.c_str()));
+        return -1;
+    }
+    if (itemUpdater->isImageInUse(p))
+    {
+        // Seen again by a rescan, the version owning it keeps using it
+        log<level::INFO>("Image in use by a version, skipped",
+                         entry("FILENAME=%s", imagePath.c_str()));
+        return 0;
+    }
+    if (itemUpdater->processImage(p) < 0)
     {
         // TODO Log an event then remove file
         fs::remove_all(p.string());
@@ -73,16 +92,70 @@ int BaseController::processImage(const std::string& imagePath)
     return 0;
 }
 
+BaseItemUpdater*
+    BaseController::findItemUpdater(const std::string& imagePath) const
+{
+    for (const auto& itemUpdater : itemUpdaters_)
+    {
+        // Upload directories are per updater name, so they never overlap
+        if (imagePath.starts_with(itemUpdater->getImageUploadDir()))
+        {
+            return itemUpdater.get();
+        }
+    }
+    return nullptr;
+}
+
 int BaseController::startWatching(sdbusplus::bus::bus& bus, sd_event* loop)
 {
     // On fly
     try
     {
+        std::vector<fs::path> pathsToMonitor;
+        for (const auto& itemUpdater : itemUpdaters_)
+        {
+            try
+            {
+                auto paths = itemUpdater->getPathsToMonitor();
+                pathsToMonitor.insert(pathsToMonitor.end(), paths.begin(),
+                                      paths.end());
+            }
+            catch (const std::exception& e)
+            {
+                if (itemUpdaters_.size() == 1)
+                {
+                    throw;
+                }
+                // Other updaters of the process keep running
+                log<level::ERR>(e.what());
+            }
+        }
+        if (pathsToMonitor.empty())
+        {
+            throw std::runtime_error("No " + getName() + " to monitor");
+        }
 
-        nvidia::software::updater::Watch watch(
-            loop, abstractItemUpdater_->getPathsToMonitor(),
+        watch = std::make_unique<Watch>(
+            loop, pathsToMonitor,
             std::bind(std::mem_fn(&BaseController::processImage), this,
                       std::placeholders::_1));
+        for (const auto& itemUpdater : itemUpdaters_)
+        {
+            // UUIDs registered after startup get their directory watched
+            itemUpdater->setUploadDirCallback([this](const fs::path& path) {
+                try
+                {
+                    watch->addPath(path);
+                }
+                catch (const std::exception& e)
+                {
+                    log<level::ERR>("Unable to watch upload directory",
+                                    entry("PATH=%s", path.c_str()),
+                                    entry("ERROR=%s", e.what()));
+                }
+            });
+        }
+        logStartupPhase(getName(), "watching uploads");
         bus.attach_event(loop, SD_EVENT_PRIORITY_NORMAL);
         sd_event_loop(loop);
     }
@@ -96,10 +169,89 @@ int BaseController::startWatching(sdbusplus::bus::bus& bus, sd_event* loop)
 }
 int BaseController::processExistingImages()
 {
-    abstractItemUpdater_->watchNewlyAddedDevice();
-    abstractItemUpdater_->readExistingFirmWare();
+    for (const auto& itemUpdater : itemUpdaters_)
+    {
+        itemUpdater->watchNewlyAddedDevice();
+        itemUpdater->readExistingFirmWare();
+        logStartupPhase(itemUpdater->getName(), "existing firmware read");
+    }
     return 0;
 }
+
+int BaseController::scheduleExistingImages(sd_event* loop)
+{
+    for (const auto& itemUpdater : itemUpdaters_)
+    {
+        itemUpdater->watchNewlyAddedDevice();
+        // Last known firmware is published at once, revalidated later
+        itemUpdater->publishCachedFirmWare();
+        logStartupPhase(itemUpdater->getName(), "cached firmware published");
+        itemUpdater->queueExistingFirmWare(
+            [this](std::function<void()> step) {
+                queueStartupStep(std::move(step));
+            },
+            [this, name = itemUpdater->getName()]() {
+                logStartupPhase(name, "existing firmware read");
+            });
+    }
+    // Idle priority, inotify and D-Bus events are served in between steps
+    if (sd_event_add_defer(loop, &startupSource, runStartupWork, this) < 0 ||
+        sd_event_source_set_priority(startupSource, SD_EVENT_PRIORITY_IDLE) <
+            0 ||
+        sd_event_source_set_enabled(startupSource, SD_EVENT_ONESHOT) < 0)
+    {
+        log<level::ERR>("Unable to schedule existing images processing");
+        return -1;
+    }
+    return 0;
+}
+
+void BaseController::queueStartupStep(std::function<void()> step)
+{
+    startupWork.emplace_back(std::move(step));
+    if (startupSource != nullptr)
+    {
+        sd_event_source_set_enabled(startupSource, SD_EVENT_ONESHOT);
+    }
+}
+
+int BaseController::runStartupWork(sd_event_source* source, void* userdata)
+{
+    auto controller = static_cast<BaseController*>(userdata);
+    if (controller->startupWork.empty())
+    {
+        return 0;
+    }
+    auto step = std::move(controller->startupWork.front());
+    controller->startupWork.pop_front();
+    try
+    {
+        step();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Error processing existing images",
+                        entry("ERROR=%s", e.what()));
+    }
+    // The defer source is one shot, armed again for the next step
+    if (!controller->startupWork.empty())
+    {
+        sd_event_source_set_enabled(source, SD_EVENT_ONESHOT);
+    }
+    return 0;
+}
+
+void BaseController::logStartupPhase(const std::string& updater,
+                                     const std::string& phase) const
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - startTime)
+                       .count();
+    log<level::INFO>("Startup phase reached",
+                     entry("UPDATER=%s", updater.c_str()),
+                     entry("PHASE=%s", phase.c_str()),
+                     entry("ELAPSED_MS=%lld", static_cast<long long>(elapsed)));
+}
 } // namespace updater
 } // namespace software
 } // namespace nvidia
@@ -21,6 +21,13 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "watch.hpp"
+
+#include <systemd/sd-event.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
 
 namespace nvidia
 {
@@ -36,17 +43,73 @@ class BaseController
 {
   protected:
     /**
-     * @var BaseItemUpdater
+     * @var BaseItemUpdater - item updaters hosted by this process, sharing
+     * the bus, the event loop and the image watch
+     */
+    std::vector<std::unique_ptr<BaseItemUpdater>> itemUpdaters_;
+
+    /**
+     * @brief Find the item updater owning an uploaded image
+     *
+     * @param imagePath
+     * @return BaseItemUpdater* - nullptr if not under any upload directory
+     */
+    BaseItemUpdater* findItemUpdater(const std::string& imagePath) const;
+
+    /**
+     * @brief Logs the time elapsed since the controller was created
+     *
+     * @param updater - updater name
+     * @param phase - startup phase reached
+     */
+    void logStartupPhase(const std::string& updater,
+                         const std::string& phase) const;
+
+    /**
+     * @brief Appends a step to the startup work and arms its defer source
+     *
+     * @param step
+     */
+    void queueStartupStep(std::function<void()> step);
+
+    /**
+     * @brief sd-event defer callback running one step of the startup work
+     *
+     * @param source - defer source
+     * @param userdata - pointer to BaseController object
+     * @return int
      */
-    std::unique_ptr<BaseItemUpdater> abstractItemUpdater_;
+    static int runStartupWork(sd_event_source* source, void* userdata);
+
+    /** @brief creation time, reference of the startup timing logs */
+    std::chrono::steady_clock::time_point startTime =
+        std::chrono::steady_clock::now();
+
+    /** @brief steps of the deferred existing images processing */
+    std::deque<std::function<void()>> startupWork;
+
+    /** @brief defer source draining startupWork */
+    sd_event_source* startupSource = nullptr;
+
+    /** @brief watch of the upload directories, extended at runtime */
+    std::unique_ptr<Watch> watch;
 
   public:
     /**
      * @brief constructor
      * @param abstractItemUpdater
      */
-    BaseController(std::unique_ptr<BaseItemUpdater>& abstractItemUpdater) :
-        abstractItemUpdater_(std::move(abstractItemUpdater))
+    BaseController(std::unique_ptr<BaseItemUpdater>& abstractItemUpdater)
+    {
+        itemUpdaters_.emplace_back(std::move(abstractItemUpdater));
+    }
+
+    /**
+     * @brief constructor hosting several item updaters in one process
+     * @param itemUpdaters
+     */
+    BaseController(std::vector<std::unique_ptr<BaseItemUpdater>>& itemUpdaters) :
+        itemUpdaters_(std::move(itemUpdaters))
     {}
 
     /**
@@ -54,7 +117,16 @@ class BaseController
      * @return
      */
     virtual ~BaseController()
-    {}
+    {
+        for (const auto& itemUpdater : itemUpdaters_)
+        {
+            itemUpdater->setUploadDirCallback(nullptr);
+        }
+        if (startupSource != nullptr)
+        {
+            sd_event_source_unref(startupSource);
+        }
+    }
 
     /**
      * @brief Get the Name item updater
@@ -63,7 +135,12 @@ class BaseController
      */
     virtual std::string getName() const
     {
-        return abstractItemUpdater_->getName();
+        std::string name;
+        for (const auto& itemUpdater : itemUpdaters_)
+        {
+            name += (name.empty() ? "" : ",") + itemUpdater->getName();
+        }
+        return name;
     }
 
     /**
@@ -89,6 +166,16 @@ class BaseController
      * @return int
      */
     int processExistingImages();
+
+    /**
+     * @brief Lazy variant of processExistingImages, the existing images are
+     * processed step by step from the event loop once it runs, so uploads
+     * are watched right from the start
+     *
+     * @param loop
+     * @return int
+     */
+    int scheduleExistingImages(sd_event* loop);
 };
 } // namespace updater
 } // namespace software
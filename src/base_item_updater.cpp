@@ -48,8 +48,12 @@ namespace updater
 using namespace phosphor::logging;
 namespace LoggingServer = sdbusplus::xyz::openbmc_project::Logging::server;
 
+/** @brief bytes of an upload hashed per event loop iteration */
+constexpr size_t digestStepSize = 8 * 1024 * 1024;
+
 int BaseItemUpdater::processImage(std::filesystem::path& filePath)
 {
+    auto start = ActivationTrace::Clock::now();
     // Compute id
     std::string uniqueIdentifier = filePath.parent_path().string();
     boost::replace_all(uniqueIdentifier, getImageUploadDir(), "");
@@ -59,9 +63,128 @@ int BaseItemUpdater::processImage(std::filesystem::path& filePath)
         std::cerr << "\n Version ID not found ";
         return -1;
     }
+    // Hash the image once here, later stages use the stored digest. A
+    // rewritten upload restarts the digest of its path.
+    auto digester =
+        std::make_shared<ImageDigester>(filePath, IMAGE_DIGEST_ALGORITHM);
+    pendingDigests[filePath.string()] = digester;
+    digestImageStep(filePath, std::move(digester), id, uniqueIdentifier,
+                    start);
+    return 0;
+}
+
+bool BaseItemUpdater::isImageInUse(const std::filesystem::path& filePath) const
+{
+    return std::any_of(versions.begin(), versions.end(),
+                       [&filePath](const auto& version) {
+                           return version.second->path() == filePath.string() &&
+                                  version.second->isImageInUse();
+                       });
+}
+
+void BaseItemUpdater::digestImageStep(const std::filesystem::path& filePath,
+                                      std::shared_ptr<ImageDigester> digester,
+                                      const std::string& id,
+                                      const std::string& uniqueIdentifier,
+                                      ActivationTrace::Clock::time_point start)
+{
+    // Each step returns to the event loop, D-Bus calls and inotify events
+    // are served while a large image is hashed
+    callAfter(std::chrono::milliseconds(0), [this, filePath, digester, id,
+                                             uniqueIdentifier, start]() {
+        auto pending = pendingDigests.find(filePath.string());
+        if (pending == pendingDigests.end() || pending->second != digester)
+        {
+            // Replaced by a newer upload of the same path
+            return;
+        }
+        if (!digester->update(digestStepSize))
+        {
+            digestImageStep(filePath, digester, id, uniqueIdentifier, start);
+            return;
+        }
+        pendingDigests.erase(pending);
+        auto versionId =
+            stageImage(filePath, id, uniqueIdentifier, digester->result());
+        activationTrace.record(versionId.empty() ? id : versionId, "",
+                               TracePhase::ImageStaging, start,
+                               !versionId.empty());
+        if (versionId.empty() && !isImageInUse(filePath))
+        {
+            // TODO Log an event then remove file
+            std::error_code ec;
+            std::filesystem::remove_all(filePath, ec);
+            auto msg = "Removing " + filePath.string();
+            log<level::ERR>(msg.c_str());
+        }
+    });
+}
+
+std::string BaseItemUpdater::stageImage(const std::filesystem::path& filePath,
+                                        std::string id,
+                                        const std::string& uniqueIdentifier,
+                                        const std::string& digest)
+{
+#ifdef CONTENT_ADDRESSED_VERSION_ID
+    if (!digest.empty())
+    {
+        id += "_" + digest.substr(0, 8);
+    }
+    // Every upload gets its own ID, the previous upload of the directory is
+    // replaced here instead of by initiateUpdateImage
+    for (auto it = versions.begin(); it != versions.end();)
+    {
+        auto& version = it->second;
+        std::filesystem::path versionPath = version->path();
+        if (it->first != id &&
+            versionPath.parent_path() == filePath.parent_path() &&
+            version->activation() != Version::Status::Activating)
+        {
+            log<level::INFO>("Replacing the previous upload",
+                             entry("VERSION_ID=%s", it->first.c_str()));
+            if (versionPath != filePath)
+            {
+                std::error_code ec;
+                std::filesystem::remove(versionPath, ec);
+            }
+            else
+            {
+                version->releaseRetainedImage();
+            }
+            auto versionId = (it++)->first;
+            erase(versionId);
+            continue;
+        }
+        it++;
+    }
+#endif
+    auto it = versions.find(id);
+    if (!digest.empty() && it != versions.end() &&
+        it->second->activation() == Version::Status::Ready &&
+        it->second->getImageDigest() == digest)
+    {
+        log<level::INFO>("Same image is already staged, upload ignored",
+                         entry("VERSION_ID=%s", id.c_str()),
+                         entry("DIGEST=%s", digest.c_str()));
+        if (it->second->path() != filePath.string())
+        {
+            std::error_code ec;
+            std::filesystem::remove(filePath, ec);
+        }
+        return id;
+    }
     auto objPath = std::string{SOFTWARE_OBJPATH} + '/' + id;
-    return initiateUpdateImage(objPath, filePath.string(), filePath.stem(), id,
-                               uniqueIdentifier);
+    if (initiateUpdateImage(objPath, filePath.string(), filePath.stem(), id,
+                            uniqueIdentifier) < 0)
+    {
+        return {};
+    }
+    it = versions.find(id);
+    if (it != versions.end())
+    {
+        it->second->setImageDigest(digest);
+    }
+    return id;
 }
 
 void BaseItemUpdater::erase(const std::string& versionId)
@@ -77,6 +200,10 @@ void BaseItemUpdater::erase(const std::string& versionId)
     else
     {
         (*(it->second)).deleteObject.reset(nullptr);
+        // Whatever erases the version, nothing resumes its activation now
+        it->second->removeRetainedImage();
+        activationSubscriptions.erase(std::string{SOFTWARE_OBJPATH} + '/' +
+                                      versionId);
 
         versions.erase(it);
     }
@@ -84,38 +211,257 @@ void BaseItemUpdater::erase(const std::string& versionId)
 
 void BaseItemUpdater::readDeviceDetails(std::string& p)
 {
-    auto version = getVersion(p);
+    invalidateDeviceSnapshot(p);
+    const auto& snapshot = getDeviceSnapshot(p);
+    auto version = snapshot.version;
+    refreshCachedDevice(p, snapshot);
     createSoftwareObject(p, version);
     // Add matches for Device Inventory's property changes
-    deviceMatches.emplace_back(
-        bus, MatchRules::propertiesChanged(p, ITEM_IFACE),
-        std::bind(&BaseItemUpdater::onInventoryChangedMsg, this,
-                  std::placeholders::_1)); // For present
-    deviceMatches.emplace_back(
-        bus, MatchRules::propertiesChanged(p, ASSET_IFACE),
-        std::bind(&BaseItemUpdater::onInventoryChangedMsg, this,
-                  std::placeholders::_1)); // For model
+    watchDeviceProperties(p, ITEM_IFACE,
+                          std::bind(&BaseItemUpdater::onInventoryChangedMsg,
+                                    this, std::placeholders::_1)); // For present
+    watchDeviceProperties(p, ASSET_IFACE,
+                          std::bind(&BaseItemUpdater::onInventoryChangedMsg,
+                                    this, std::placeholders::_1)); // For model
+}
+
+void BaseItemUpdater::watchDeviceProperties(const std::string& path,
+                                            const std::string& interface,
+                                            SignalRouter::Handler callback)
+{
+    auto key = std::make_pair(path, interface);
+    if (!devicePropertiesSubscriptions.contains(key))
+    {
+        devicePropertiesSubscriptions.emplace(
+            key, signalRouter->propertiesChanged(path, interface,
+                                                 std::move(callback)));
+    }
+}
+
+void BaseItemUpdater::addDeviceMatch(
+    const std::string& rule, sdbusplus::bus::match_t::callback_t callback)
+{
+    if (!deviceMatches.contains(rule))
+    {
+        deviceMatches.try_emplace(rule, bus, rule, std::move(callback));
+    }
+}
+
+void BaseItemUpdater::refreshDevice(const std::string& inventoryPath)
+{
+    invalidateDeviceSnapshot(inventoryPath);
+    const auto& snapshot = getDeviceSnapshot(inventoryPath);
+    auto version = snapshot.version;
+    refreshCachedDevice(inventoryPath, snapshot);
+    if (!version.empty())
+    {
+        createSoftwareObject(inventoryPath, version);
+    }
 }
 
 void BaseItemUpdater::readExistingFirmWare()
 {
     auto paths = getItemUpdaterInventoryPaths();
+    pruneInventoryCache(paths);
     for (auto p : paths)
     {
         readDeviceDetails(p);
     }
     // update the Existing firmwares
+    for (auto filePath : getPersistedImages())
+    {
+        // Ignore return
+        processImage(filePath);
+    }
+}
+
+void BaseItemUpdater::queueExistingFirmWare(
+    std::function<void(std::function<void()>)> enqueue,
+    std::function<void()> onDone)
+{
+    enqueue([this, enqueue, onDone = std::move(onDone)]() {
+        auto paths = getItemUpdaterInventoryPaths();
+        pruneInventoryCache(paths);
+        for (auto& p : paths)
+        {
+            enqueue([this, p]() mutable { readDeviceDetails(p); });
+        }
+        // Images need the software objects of the devices, queue them after
+        enqueue([this, enqueue, onDone]() {
+            for (auto& filePath : getPersistedImages())
+            {
+                enqueue([this, filePath]() mutable { processImage(filePath); });
+            }
+            enqueue(onDone);
+        });
+    });
+}
+
+void BaseItemUpdater::publishCachedFirmWare()
+{
+    for (const auto& [path, entry] : getInventoryCache().getEntries())
+    {
+        if (!deviceIds.contains(entry.uuid))
+        {
+            // Not a supported device anymore
+            continue;
+        }
+        auto& snapshot = deviceSnapshots[path];
+        snapshot.version = entry.version;
+        snapshot.model = entry.model;
+        snapshot.manufacturer = entry.manufacturer;
+        snapshot.flashedDigest = entry.flashedDigest;
+        snapshot.deviceRead = true;
+        createSoftwareObject(path, entry.version);
+    }
+}
+
+InventoryCache& BaseItemUpdater::getInventoryCache()
+{
+    if (!inventoryCache)
+    {
+        auto file = std::filesystem::path(IMG_DIR_PERSIST) / ".cache" /
+                    (getName() + ".json");
+        inventoryCache = std::make_unique<InventoryCache>(file);
+        inventoryCache->load();
+    }
+    return *inventoryCache;
+}
+
+FlashHistory& BaseItemUpdater::getFlashHistory()
+{
+    if (!flashHistory)
+    {
+        auto file = std::filesystem::path(IMG_DIR_PERSIST) / ".cache" /
+                    (getName() + "_flash.json");
+        flashHistory = std::make_unique<FlashHistory>(file);
+        flashHistory->load();
+    }
+    return *flashHistory;
+}
+
+uint32_t BaseItemUpdater::getAdaptiveTimeout(
+    [[maybe_unused]] const std::string& inventoryPath,
+    [[maybe_unused]] uintmax_t imageSize)
+{
+#ifdef ADAPTIVE_UPDATE_TIMEOUT
+    const auto& snapshot = getDeviceSnapshot(inventoryPath);
+    return getFlashHistory().getTimeout(
+        FlashHistory::makeKey(snapshot.model, imageSize), getTimeout());
+#else
+    return getTimeout();
+#endif
+}
+
+void BaseItemUpdater::recordFlashDuration(
+    [[maybe_unused]] const std::string& inventoryPath,
+    [[maybe_unused]] uintmax_t imageSize,
+    [[maybe_unused]] std::chrono::seconds duration)
+{
+#ifdef ADAPTIVE_UPDATE_TIMEOUT
+    const auto& snapshot = getDeviceSnapshot(inventoryPath);
+    auto& history = getFlashHistory();
+    history.add(FlashHistory::makeKey(snapshot.model, imageSize), duration);
+    history.save();
+#endif
+}
+
+void BaseItemUpdater::refreshCachedDevice(const std::string& inventoryPath,
+                                          const DeviceSnapshot& snapshot)
+{
+    if (snapshot.version.empty())
+    {
+        // Device not readable now, keep what is known
+        return;
+    }
+    auto& cache = getInventoryCache();
+    auto previous = cache.find(inventoryPath);
+    const auto& entries = cache.getEntries();
+    bool sharedVersion =
+        previous &&
+        std::any_of(entries.begin(), entries.end(), [&](const auto& item) {
+            return item.first != inventoryPath &&
+                   item.second.version == previous->version;
+        });
+    if (previous && previous->version != snapshot.version && !sharedVersion)
+    {
+        // Replace the object published with the stale version, unless
+        // other devices still run it
+        auto it = versions.find(getIdProperty(previous->version));
+        if (it != versions.end() &&
+            it->second->activation() == Version::Status::Active &&
+            it->second->getVersionString() == previous->version)
+        {
+            erase(it->first);
+        }
+    }
+    InventoryCache::Entry entry;
+    entry.version = snapshot.version;
+    entry.model = snapshot.model;
+    entry.manufacturer = snapshot.manufacturer;
+    entry.uuid = getUUID(snapshot.model, snapshot.manufacturer);
+    if (!snapshot.flashedDigest.empty())
+    {
+        bool flashed = previous &&
+                       previous->flashedDigest == snapshot.flashedDigest &&
+                       !previous->flashedVersion.empty();
+        if (flashed && previous->flashedVersion != snapshot.version)
+        {
+            // Changed by something else since our flash
+            deviceSnapshots[inventoryPath].flashedDigest.clear();
+        }
+        else
+        {
+            entry.flashedDigest = snapshot.flashedDigest;
+            entry.flashedVersion =
+                flashed ? previous->flashedVersion : snapshot.version;
+        }
+    }
+    if (cache.update(inventoryPath, std::move(entry)))
+    {
+        cache.save();
+    }
+}
+
+void BaseItemUpdater::setFlashedDigest(const std::string& inventoryPath,
+                                       const std::string& digest)
+{
+    deviceSnapshots[inventoryPath].flashedDigest = digest;
+    auto& cache = getInventoryCache();
+    if (cache.setFlashedDigest(inventoryPath, digest))
+    {
+        cache.save();
+    }
+}
+
+void BaseItemUpdater::pruneInventoryCache(
+    const std::vector<std::string>& inventoryPaths)
+{
+    if (inventoryPaths.empty())
+    {
+        // Rather a failed lookup than all devices gone
+        return;
+    }
+    auto& cache = getInventoryCache();
+    if (cache.retain(inventoryPaths))
+    {
+        cache.save();
+    }
+}
+
+std::vector<std::filesystem::path> BaseItemUpdater::getPersistedImages() const
+{
+    std::vector<std::filesystem::path> images;
     if (std::filesystem::exists(IMG_DIR_PERSIST))
     {
         for (const auto& entry :
              std::filesystem::directory_iterator(IMG_DIR_PERSIST))
         {
-            // Ignore return
             std::filesystem::path filePath = entry.path();
             std::error_code ec;
             if (std::filesystem::is_regular_file(filePath, ec))
             {
-                processImage(filePath);
+                images.push_back(filePath);
             }
             if (ec)
             {
@@ -123,6 +469,34 @@ void BaseItemUpdater::readExistingFirmWare()
             }
         }
     }
+    return images;
+}
+
+void BaseItemUpdater::getItemUpdaterInventoryPathsAsync(
+    std::function<void(std::vector<std::string>)> callback)
+{
+    if (!inventorySupported())
+    {
+        // Still reply from the event loop, callers rely on it
+        callAfter(std::chrono::milliseconds(0),
+                  [this, callback = std::move(callback)]() {
+                      callback(getItemUpdaterInventoryPaths());
+                  });
+        return;
+    }
+    getinventoryPathAsync(
+        inventoryIface, [this, callback = std::move(callback)](
+                            std::vector<std::string> paths) {
+            std::vector<std::string> ret;
+            for (auto p : paths)
+            {
+                if (pathIsValidDevice(p))
+                {
+                    ret.push_back(p);
+                }
+            }
+            callback(std::move(ret));
+        });
 }
 
 void BaseItemUpdater::createSoftwareObject(const std::string& inventoryPath,
@@ -130,8 +504,9 @@ void BaseItemUpdater::createSoftwareObject(const std::string& inventoryPath,
 {
     auto versionId = getIdProperty(deviceVersion);
 
-    auto model = getModel(inventoryPath);
-    auto manufacturer = getManufacturer(inventoryPath);
+    const auto& snapshot = getDeviceSnapshot(inventoryPath);
+    const auto& model = snapshot.model;
+    const auto& manufacturer = snapshot.manufacturer;
     auto objPath = std::string(SOFTWARE_OBJPATH) + "/" + versionId;
 
     auto it = versions.find(versionId);
@@ -182,46 +557,56 @@ void BaseItemUpdater::onInventoryChanged(const std::string& devicePath,
     std::optional<bool> present;
     std::optional<std::string> model;
     std::optional<std::string> manufacturer;
+    auto& snapshot = deviceSnapshots[devicePath];
 
     auto p = properties.find(PRESENT);
     if (p != properties.end())
     {
         present = std::get<bool>(p->second);
-        inventoryObjectStatusMap[devicePath].present = *present;
+        snapshot.present = *present;
+        if (!snapshot.present)
+        {
+            // A device plugged in later may run anything
+            setFlashedDigest(devicePath, "");
+        }
     }
     p = properties.find(MODEL);
     if (p != properties.end())
     {
         model = std::get<std::string>(p->second);
-        inventoryObjectStatusMap[devicePath].model = *model;
+        snapshot.inventoryModel = *model;
     }
     p = properties.find(MANUFACTURER);
     if (p != properties.end())
     {
         manufacturer = std::get<std::string>(p->second);
-        inventoryObjectStatusMap[devicePath].manufacturer = *manufacturer;
+        snapshot.inventoryManufacturer = *manufacturer;
     }
     if (!present.has_value() && !model.has_value() && !manufacturer.has_value())
     {
         return;
     }
+    snapshot.inventoryRead = !snapshot.inventoryModel.empty() &&
+                             !snapshot.inventoryManufacturer.empty();
 
-    if (inventoryObjectStatusMap[devicePath].present)
+    if (snapshot.present)
     {
         // If model is not updated, let's wait for it
-        if (inventoryObjectStatusMap[devicePath].model.empty())
+        if (snapshot.inventoryModel.empty())
         {
             log<level::DEBUG>("Waiting for model to be updated");
             return;
         }
         // If manufacturer is not updated, let's wait for it
-        if (inventoryObjectStatusMap[devicePath].manufacturer.empty())
+        if (snapshot.inventoryManufacturer.empty())
         {
             log<level::DEBUG>("Waiting for manufacturer to be updated");
             return;
         }
 
-        auto version = getVersion(devicePath);
+        // The device may have been replaced, read it again
+        invalidateDeviceSnapshot(devicePath);
+        auto version = getDeviceSnapshot(devicePath).version;
         if (!version.empty())
         {
             createSoftwareObject(devicePath, version);
@@ -241,6 +626,91 @@ void BaseItemUpdater::onInventoryChanged(const std::string& devicePath,
         }
     }
 }
+
+const DeviceSnapshot&
+    BaseItemUpdater::getDeviceSnapshot(const std::string& inventoryPath)
+{
+    auto& snapshot = deviceSnapshots[inventoryPath];
+    if (!snapshot.deviceRead)
+    {
+        auto device = readDeviceSnapshot(inventoryPath);
+        snapshot.version = std::move(device.version);
+        snapshot.model = std::move(device.model);
+        snapshot.manufacturer = std::move(device.manufacturer);
+        snapshot.deviceRead = true;
+    }
+    return snapshot;
+}
+
+const DeviceSnapshot&
+    BaseItemUpdater::getInventorySnapshot(const std::string& inventoryPath)
+{
+    auto& snapshot = deviceSnapshots[inventoryPath];
+    if (!snapshot.inventoryRead)
+    {
+        // Kept up to date by the PropertiesChanged matches afterwards
+        auto service = getDbusService(inventoryPath, ASSET_IFACE);
+        auto properties = getAllProperties(
+            service.c_str(), inventoryPath.c_str(), ASSET_IFACE);
+        snapshot.inventoryManufacturer =
+            findProperty<std::string>(properties, MANUFACTURER).value_or("");
+        snapshot.inventoryModel =
+            findProperty<std::string>(properties, MODEL).value_or("");
+        snapshot.inventoryRead = true;
+    }
+    return snapshot;
+}
+
+void BaseItemUpdater::getInventorySnapshotAsync(
+    const std::string& inventoryPath,
+    std::function<void(const DeviceSnapshot&)> callback)
+{
+    const auto& snapshot = deviceSnapshots[inventoryPath];
+    if (snapshot.inventoryRead)
+    {
+        callback(snapshot);
+        return;
+    }
+    getServicesAsync(
+        inventoryPath, ASSET_IFACE,
+        [this, inventoryPath, callback = std::move(callback)](
+            std::vector<std::string> services) mutable {
+            if (services.empty())
+            {
+                callback(deviceSnapshots[inventoryPath]);
+                return;
+            }
+            getAllPropertiesAsync(
+                services.front(), inventoryPath, ASSET_IFACE,
+                [this, inventoryPath, callback = std::move(callback)](
+                    std::optional<Properties> properties) {
+                    auto& snapshot = deviceSnapshots[inventoryPath];
+                    if (properties)
+                    {
+                        snapshot.inventoryManufacturer =
+                            findProperty<std::string>(*properties,
+                                                      MANUFACTURER)
+                                .value_or("");
+                        snapshot.inventoryModel =
+                            findProperty<std::string>(*properties, MODEL)
+                                .value_or("");
+                        snapshot.inventoryRead = true;
+                    }
+                    callback(snapshot);
+                });
+        });
+}
+
+void BaseItemUpdater::invalidateDeviceSnapshot(
+    const std::string& inventoryPath)
+{
+    auto it = deviceSnapshots.find(inventoryPath);
+    if (it != deviceSnapshots.end())
+    {
+        it->second.deviceRead = false;
+    }
+}
+
 void BaseItemUpdater::invokeActivation(
     const std::unique_ptr<Version>& activation)
 {
@@ -264,14 +734,20 @@ int BaseItemUpdater::initiateUpdateImage(const std::string& objPath,
                              entry("VERSION_ID=%s", versionId.c_str()));
             return -1;
         }
+        if (it->second->path() == filePath)
+        {
+            // The new upload overwrote the image of the previous one
+            it->second->releaseRetainedImage();
+        }
         erase(versionId); // remove
     }
-    else
+    if (!activationSubscriptions.contains(objPath))
     {
-        activationMatches.emplace_back(
-            bus, MatchRules::propertiesChanged(objPath, ACTIVATE_INTERFACE),
-            std::bind(&BaseItemUpdater::onReqActivationChangedMsg, this,
-                      std::placeholders::_1));
+        activationSubscriptions.emplace(
+            objPath, signalRouter->propertiesChanged(
+                         objPath, ACTIVATE_INTERFACE,
+                         std::bind(&BaseItemUpdater::onReqActivationChangedMsg,
+                                   this, std::placeholders::_1)));
     }
     // delete the activation interface and create again
     // so that PLDMD will identify
@@ -328,9 +804,13 @@ std::unique_ptr<Version> BaseItemUpdater::createVersion(
     const std::string& versionString, const std::string& uniqueIdentifier,
     const std::string& filePath, const Version::Status& activationStatus)
 {
-    auto pair = deviceIds.find(uniqueIdentifier);
-    std::string model = get<0>(pair->second);
-    std::string manufacturer = get<1>(pair->second);
+    std::string model;
+    std::string manufacturer;
+    if (auto entry = deviceIds.find(uniqueIdentifier))
+    {
+        model = entry->model;
+        manufacturer = entry->manufacturer;
+    }
     auto versionPtr = std::make_unique<Version>(
         bus, versionString, objPath, uniqueIdentifier, versionId, filePath,
         activationStatus, model, manufacturer,
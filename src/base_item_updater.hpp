@@ -20,11 +20,17 @@
 
 #include "activation_listener.hpp"
 #include "dbusutils.hpp"
+#include "device_id_table.hpp"
+#include "device_registry.hpp"
+#include "flash_history.hpp"
+#include "image_digest.hpp"
+#include "inventory_cache.hpp"
 #include "version.hpp"
 
 #include <sdbusplus/server.hpp>
 
 #include <filesystem>
+#include <functional>
 #include <string>
 
 namespace nvidia
@@ -86,6 +92,17 @@ class BaseItemUpdater :
                 }
             }
         }
+        if (activationTrace.enabled())
+        {
+            activationMetrics = std::make_unique<ActivationMetrics>(
+                bus,
+                (sdbusplus::message::object_path(ACTIVATION_METRICS_OBJPATH) /
+                 name)
+                    .str,
+                activationTrace,
+                std::filesystem::path(ACTIVATION_TRACE_DUMP_DIR) /
+                    (name + ".json"));
+        }
     }
     /**
      * @brief Destructor
@@ -172,6 +189,16 @@ class BaseItemUpdater :
     {
         return updateTogether;
     }
+    /**
+     * @brief Get the upload directory of a UUID
+     *
+     * @param uuid
+     * @return std::filesystem::path
+     */
+    std::filesystem::path getUploadDir(const std::string& uuid) const
+    {
+        return std::filesystem::path(getImageUploadDir()) / uuid;
+    }
     /**
      * @brief Get the Paths To Monitor object
      *
@@ -180,11 +207,9 @@ class BaseItemUpdater :
     virtual std::vector<std::filesystem::path> getPathsToMonitor() const
     {
         std::vector<std::filesystem::path> pathsToMonitor;
-        for (const auto& sm : deviceIds)
+        for (const auto& [uuid, entry] : deviceIds)
         {
-            std::filesystem::path pathToWatch(getImageUploadDir());
-            pathToWatch /= sm.first;
-            pathsToMonitor.push_back(pathToWatch);
+            pathsToMonitor.push_back(getUploadDir(uuid));
         }
         if (pathsToMonitor.size() < 1)
         {
@@ -193,6 +218,13 @@ class BaseItemUpdater :
         }
         return pathsToMonitor;
     }
+    /**
+     * @brief Get the images stored in the persistent image directory
+     *
+     * @return std::vector<std::filesystem::path>
+     */
+    std::vector<std::filesystem::path> getPersistedImages() const;
+
     /**
      * @brief Get the Item Updater Inventory Paths object
      *
@@ -217,6 +249,17 @@ class BaseItemUpdater :
         return ret;
     }
 
+    /**
+     * @brief Get the Item Updater Inventory Paths object without blocking
+     * the event loop. Updaters without inventory list their devices locally,
+     * so the mapper is only queried when inventory is supported. The
+     * callback is always invoked from the event loop
+     *
+     * @param callback
+     */
+    void getItemUpdaterInventoryPathsAsync(
+        std::function<void(std::vector<std::string>)> callback) override;
+
     /**
      * @brief inserts into map which contains UUid to model-manufacture hash
      *
@@ -228,11 +271,22 @@ class BaseItemUpdater :
                                  const std::string& model,
                                  const std::string& manufacture)
     {
+        if (deviceIds.insert(uuid, model, manufacture) && uploadDirCallback)
+        {
+            uploadDirCallback(getUploadDir(uuid));
+        }
+    }
 
-        auto pair =
-            std::make_tuple(std::move(model), std::move(manufacture), "");
-        auto npair = std::make_pair(std::move(uuid), pair);
-        deviceIds.insert(npair);
+    /**
+     * @brief Set the callback notified when a model/manufacturer to UUID
+     * mapping added after startup needs a new upload directory
+     *
+     * @param callback - gets the directory
+     */
+    void setUploadDirCallback(
+        std::function<void(const std::filesystem::path&)> callback)
+    {
+        uploadDirCallback = std::move(callback);
     }
     /**
      * @brief for a given Model and manufacture gets UUID
@@ -244,35 +298,33 @@ class BaseItemUpdater :
     virtual std::string getUUID(const std::string& model,
                                 const std::string& manufacture)
     {
-        std::string uuid = "";
-        for (auto& it : deviceIds)
-        {
-            if (uuid.empty())
-            {
-                // use first uuid as default
-                // this is to allow update even if
-                // model mismatch from gpumgr occurs
-                uuid = it.first;
-            }
-            auto& pair = it.second;
-            if (get<0>(pair) == model && get<1>(pair) == manufacture)
-            {
-                uuid = it.first;
-            }
-        }
-        return uuid;
+        // falls back to the first uuid, this is to allow update even if
+        // model mismatch from gpumgr occurs
+        return deviceIds.getUUID(model, manufacture);
     }
 
     /**
      * @brief Process images,
      *          1) Creates Unique ID for dbus object
-     *          2) calls initiates update
+     *          2) hashes the image from the event loop
+     *          3) calls initiates update once the digest is known
      *
      * @param filePath
-     * @return int
+     * @return int - -1 if the image has no version ID, a later failure
+     *         removes the image itself
      */
     virtual int processImage(std::filesystem::path& filePath);
 
+    /**
+     * @brief Checks whether the file is the image of a version that still
+     * needs it, such a file must neither be processed again nor removed
+     *
+     * @param filePath
+     * @return true
+     * @return false
+     */
+    bool isImageInUse(const std::filesystem::path& filePath) const;
+
     /**
      * @brief removes inventory path from version dbus object
      *
@@ -286,6 +338,35 @@ class BaseItemUpdater :
      */
     void readExistingFirmWare();
 
+    /**
+     * @brief Reads the firmware of one device again and reconciles its
+     * software object, the other devices are not read
+     *
+     * @param inventoryPath
+     */
+    void refreshDevice(const std::string& inventoryPath) override;
+
+    /**
+     * @brief Splits readExistingFirmWare into small steps which are appended
+     * to the work queue, every step may append further steps. The last step
+     * calls onDone.
+     *
+     * @param enqueue - appends a step to the queue drained one step at a
+     *                  time from the event loop
+     * @param onDone - called once all existing firmware has been read
+     */
+    void queueExistingFirmWare(
+        std::function<void(std::function<void()>)> enqueue,
+        std::function<void()> onDone);
+
+    /**
+     * @brief Publishes software objects of the devices from the inventory
+     * cache without reading the devices. readExistingFirmWare or
+     * queueExistingFirmWare revalidate them afterwards.
+     *
+     */
+    void publishCachedFirmWare();
+
     /**
      * @brief deletes version from dbus
      *
@@ -355,6 +436,71 @@ class BaseItemUpdater :
      */
     virtual std::string getModel(const std::string& inventoryPath) const = 0;
 
+    /**
+     * @brief Reads version, model and manufacturer of the device. Device
+     * implementation can override this to read all of them in one pass.
+     *
+     * @param inventoryPath
+     * @return DeviceSnapshot
+     */
+    virtual DeviceSnapshot readDeviceSnapshot(const std::string& inventoryPath)
+    {
+        DeviceSnapshot snapshot;
+        snapshot.version = getVersion(inventoryPath);
+        snapshot.model = getModel(inventoryPath);
+        snapshot.manufacturer = getManufacturer(inventoryPath);
+        return snapshot;
+    }
+
+    /**
+     * @brief Get the cached snapshot of the device, the device is read only
+     * if the snapshot has no device details yet
+     *
+     * @param inventoryPath
+     * @return const DeviceSnapshot&
+     */
+    const DeviceSnapshot&
+        getDeviceSnapshot(const std::string& inventoryPath) override;
+
+    /**
+     * @brief Get the cached snapshot of the device, the inventory asset
+     * properties are read from D-Bus only if they are not known yet
+     *
+     * @param inventoryPath
+     * @return const DeviceSnapshot&
+     */
+    const DeviceSnapshot&
+        getInventorySnapshot(const std::string& inventoryPath) override;
+
+    /**
+     * @brief Get the cached snapshot of the device, the inventory asset
+     * properties are read asynchronously only if they are not known yet
+     *
+     * @param inventoryPath
+     * @param callback
+     */
+    void getInventorySnapshotAsync(
+        const std::string& inventoryPath,
+        std::function<void(const DeviceSnapshot&)> callback) override;
+
+    /**
+     * @brief Drops the device details of the snapshot so that the next
+     * getDeviceSnapshot reads the device again
+     *
+     * @param inventoryPath
+     */
+    void invalidateDeviceSnapshot(const std::string& inventoryPath) override;
+
+    /**
+     * @brief Records the digest of the image flashed to the device, it is
+     *        kept in the inventory cache across restarts
+     *
+     * @param inventoryPath
+     * @param digest
+     */
+    void setFlashedDigest(const std::string& inventoryPath,
+                          const std::string& digest) override;
+
     /**
      * @brief Get the Service Args object
      *
@@ -443,6 +589,29 @@ class BaseItemUpdater :
      */
     virtual void readDeviceDetails(std::string& p);
 
+    /**
+     * @brief Subscribes to PropertiesChanged of an interface of a device
+     * through the shared signal router, a subscription already made is not
+     * added again
+     *
+     * @param path - device inventory path
+     * @param interface
+     * @param callback
+     */
+    void watchDeviceProperties(const std::string& path,
+                               const std::string& interface,
+                               SignalRouter::Handler callback);
+
+    /**
+     * @brief Subscribes to a signal of a device, a rule already subscribed
+     * is not added again
+     *
+     * @param rule - match rule
+     * @param callback
+     */
+    void addDeviceMatch(const std::string& rule,
+                        sdbusplus::bus::match_t::callback_t callback);
+
     /**
      * @brief Verifies that the path is a valid device
      *
@@ -499,6 +668,56 @@ class BaseItemUpdater :
         return NON_PLDM_DEFAULT_TIMEOUT;
     }
 
+    /**
+     * @brief Get the update timeout derived from the flash history of the
+     *        device model and image size, the configured timeout is used
+     *        until enough flashes are recorded or when ADAPTIVE_UPDATE_TIMEOUT
+     *        is disabled
+     *
+     * @param inventoryPath
+     * @param imageSize - in bytes
+     * @return uint32_t
+     */
+    uint32_t getAdaptiveTimeout(const std::string& inventoryPath,
+                                uintmax_t imageSize) override;
+
+    /**
+     * @brief Records the duration of a successful flash, nothing is recorded
+     *        when ADAPTIVE_UPDATE_TIMEOUT is disabled
+     *
+     * @param inventoryPath
+     * @param imageSize - in bytes
+     * @param duration
+     */
+    void recordFlashDuration(const std::string& inventoryPath,
+                             uintmax_t imageSize,
+                             std::chrono::seconds duration) override;
+
+    /**
+     * @brief Get the maximum number of update services running at the same
+     *        time for one activation. Device implementation can override
+     *        this value if its devices can not be flashed concurrently.
+     *
+     * @return uint32_t
+     */
+    virtual uint32_t maxParallelUpdates()
+    {
+        return NON_PLDM_MAX_PARALLEL_UPDATES;
+    }
+
+    /**
+     * @brief Get the bus the device is attached to. Device implementation
+     *        should override this if its devices share buses.
+     *
+     * @param inventoryPath
+     * @return std::optional<uint32_t>
+     */
+    virtual std::optional<uint32_t>
+        getDeviceBus([[maybe_unused]] const std::string& inventoryPath) const
+    {
+        return std::nullopt;
+    }
+
     /**
      * @brief method to check if inventory is supported, if inventory is not
      * supported then D-Bus calls to check compatibility can be ignored
@@ -510,29 +729,112 @@ class BaseItemUpdater :
         return true; // default is supported
     }
 
+    /**
+     * @brief Get the trace recording the staging and activation steps
+     *
+     * @return ActivationTrace&
+     */
+    ActivationTrace& getActivationTrace() override
+    {
+        return activationTrace;
+    }
+
   protected:
     std::string _name;
 
-    struct inventoryObjectStatus
-    {
-        bool present;
-        std::string model;
-        std::string manufacturer;
-    };
+    std::map<std::string, DeviceSnapshot> deviceSnapshots;
+
+    /**
+     * @brief Get the inventory cache, loaded on first use
+     *
+     * @return InventoryCache&
+     */
+    InventoryCache& getInventoryCache();
+
+    /**
+     * @brief Get the flash history, loaded on first use
+     *
+     * @return FlashHistory&
+     */
+    FlashHistory& getFlashHistory();
+
+    /**
+     * @brief Compares the device read with its cached entry, replaces the
+     * software object published from a stale entry and stores the change
+     *
+     * @param inventoryPath
+     * @param snapshot - device details just read
+     */
+    void refreshCachedDevice(const std::string& inventoryPath,
+                             const DeviceSnapshot& snapshot);
 
-    std::map<std::string, inventoryObjectStatus> inventoryObjectStatusMap;
+    /**
+     * @brief Drops cache entries of devices not in the inventory anymore
+     *
+     * @param inventoryPaths
+     */
+    void pruneInventoryCache(const std::vector<std::string>& inventoryPaths);
+
+    /**
+     * @brief Hashes the next part of an image from the event loop and
+     * stages the image once its digest is complete
+     *
+     * @param filePath
+     * @param digester - digest of the upload, a newer upload of the same
+     *                   path replaces it and ends this chain
+     * @param id - version ID of the image directory
+     * @param uniqueIdentifier
+     * @param start - time the upload was picked up
+     */
+    void digestImageStep(const std::filesystem::path& filePath,
+                         std::shared_ptr<ImageDigester> digester,
+                         const std::string& id,
+                         const std::string& uniqueIdentifier,
+                         ActivationTrace::Clock::time_point start);
+
+    /**
+     * @brief Creates the version object of a hashed image, unless the same
+     * image is already staged
+     *
+     * @param filePath
+     * @param id - version ID of the image directory
+     * @param uniqueIdentifier
+     * @param digest - hex digest, empty if it could not be computed
+     * @return std::string - version ID used, empty if the image was rejected
+     */
+    std::string stageImage(const std::filesystem::path& filePath,
+                           std::string id, const std::string& uniqueIdentifier,
+                           const std::string& digest);
+
+    std::unique_ptr<InventoryCache> inventoryCache;
+
+    /** @brief digests of the uploads being hashed, by file path */
+    std::map<std::string, std::shared_ptr<ImageDigester>> pendingDigests;
+
+    std::unique_ptr<FlashHistory> flashHistory;
+
+    ActivationTrace activationTrace{ACTIVATION_TRACE_CAPACITY};
+
+    std::unique_ptr<ActivationMetrics> activationMetrics;
 
     std::map<std::string, std::unique_ptr<Version>> versions;
 
-    std::vector<sdbusplus::bus::match_t> deviceMatches;
+    /** @brief device signal subscriptions by match rule */
+    std::map<std::string, sdbusplus::bus::match_t> deviceMatches;
+
+    /** @brief device PropertiesChanged subscriptions by path and interface */
+    std::map<std::pair<std::string, std::string>, SignalRouter::Subscription>
+        devicePropertiesSubscriptions;
+
+    DeviceIdTable deviceIds;
 
-    std::map<std::string, std::tuple<std::string, std::string, std::string>>
-        deviceIds;
+    std::function<void(const std::filesystem::path&)> uploadDirCallback;
 
     std::string imageUploadDir;
     std::string busName;
     std::string serviceName;
-    std::vector<sdbusplus::bus::match_t> activationMatches;
+    /** @brief Activation PropertiesChanged subscriptions by object path */
+    std::map<std::string, SignalRouter::Subscription> activationSubscriptions;
     std::string inventoryIface;
     bool updateTogether;
     std::unique_ptr<sdbusplus::bus::match_t> deviceIfacesAddedMatch;
@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "cpld_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <fmt/format.h>
 
@@ -34,41 +35,63 @@ namespace updater
 {
 std::string CPLDItemUpdater::getVersion(const std::string& inventoryPath) const
 {
-
-    for (auto& inv : invs)
-    {
-        if (inv->getInventoryPath() == inventoryPath)
-        {
-            return inv->getVersion();
-        }
-    }
-    return "";
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->getVersion() : "";
 }
 
 std::string
     CPLDItemUpdater::getManufacturer(const std::string& inventoryPath) const
 {
-    for (auto& inv : invs)
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->getManufacturer() : "";
+}
+
+std::string CPLDItemUpdater::getModel(const std::string& inventoryPath) const
+{
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->getModel() : "";
+}
+
+DeviceSnapshot
+    CPLDItemUpdater::readDeviceSnapshot(const std::string& inventoryPath)
+{
+    DeviceSnapshot snapshot;
+    if (auto inv = invs.findByPath(inventoryPath))
     {
-        if (inv->getInventoryPath() == inventoryPath)
-        {
-            return inv->getManufacturer();
-        }
+        snapshot.version = inv->getVersion();
+        snapshot.model = inv->getModel();
+        snapshot.manufacturer = inv->getManufacturer();
     }
-    return "";
+    return snapshot;
 }
 
-std::string CPLDItemUpdater::getModel(const std::string& inventoryPath) const
+std::optional<uint32_t>
+    CPLDItemUpdater::getDeviceBus(const std::string& inventoryPath) const
 {
-    for (auto& inv : invs)
+    if (auto inv = invs.findByPath(inventoryPath))
     {
-        if (inv->getInventoryPath() == inventoryPath)
-        {
-            return inv->getModel();
-        }
+        return inv->getBus();
     }
-    return "";
+    return std::nullopt;
+}
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<CPLDItemUpdater>(bus);
 }
+} // namespace
+
+constexpr UpdaterDescriptor cpldUpdater = {
+    .name = "CPLD",
+    .busName = CPLD_BUSNAME_UPDATER,
+    .service = CPLD_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
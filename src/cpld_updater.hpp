@@ -19,10 +19,16 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 #ifndef MOCK_UTILS
 #include <cpld_util.hpp> // part of nvidia-cpld
 namespace cpldcommonutils = nvidia::cpld::common;
+#ifdef NATIVE_I2C_TRANSPORT
+#include "i2c_transport.hpp"
+
+#include <set>
+#endif
 #else
 #include <mock_util.hpp> // mock
 namespace cpldcommonutils = nvidia::mock::common;
@@ -41,6 +47,9 @@ class CPLDDevice : public cpldcommonutils::Util
     std::string model;
     std::string manufacturer;
     uint32_t cpldN;
+#if defined(NATIVE_I2C_TRANSPORT) && !defined(MOCK_UTILS)
+    std::unique_ptr<I2cTransport> transport;
+#endif
 
   public:
     CPLDDevice(const std::string& objPath, uint8_t busN, uint8_t address,
@@ -53,7 +62,35 @@ class CPLDDevice : public cpldcommonutils::Util
     {
         b = busN;
         d = address;
+#if defined(NATIVE_I2C_TRANSPORT) && !defined(MOCK_UTILS)
+        transport = std::make_unique<I2cTransport>(busN, address);
+#endif
+    }
+
+#if defined(NATIVE_I2C_TRANSPORT) && !defined(MOCK_UTILS)
+    /**
+     * @brief Reads the block registers (serial, part, manufacturer, model)
+     *        from the device. The version register holds raw bytes and is
+     *        read by the shell command, as is any failed read.
+     *
+     * @param command , size
+     * @return std::string
+     */
+    std::string runCommand(uint8_t command, size_t size) const override
+    {
+        static const std::set<uint8_t> blockRegisters = {0x99, 0x9a, 0x9e,
+                                                         0xad};
+        if (blockRegisters.contains(command))
+        {
+            auto value = transport->readBlock(command, size);
+            if (value)
+            {
+                return *value;
+            }
+        }
+        return cpldcommonutils::Util::runCommand(command, size);
     }
+#endif
 
     /*
      *@brief Gets index value
@@ -112,6 +149,11 @@ class CPLDDevice : public cpldcommonutils::Util
         return ret;
     }
 
+    uint32_t getBus() const
+    {
+        return i2cBus;
+    }
+
     const std::string getBusNum()
     {
         std::ostringstream convert;
@@ -135,7 +177,7 @@ class CPLDDevice : public cpldcommonutils::Util
  */
 class CPLDItemUpdater : public BaseItemUpdater
 {
-    std::vector<std::unique_ptr<CPLDDevice>> invs;
+    DeviceRegistry<CPLDDevice> invs;
     std::map<std::string, std::unique_ptr<SoftwareVersion>> softwareVersionIntf;
 
   public:
@@ -146,7 +188,8 @@ class CPLDItemUpdater : public BaseItemUpdater
      */
     CPLDItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(bus, CPLD_SUPPORTED_MODEL, CPLD_INVENTORY_IFACE, "CPLD",
-                        CPLD_BUSNAME_UPDATER, CPLD_UPDATE_SERVICE, false,
+                        std::string(cpldUpdater.busName),
+                        std::string(cpldUpdater.service), false,
                         CPLD_BUSNAME_INVENTORY)
     {
         nlohmann::json fruJson =
@@ -170,30 +213,18 @@ class CPLDItemUpdater : public BaseItemUpdater
                 std::string manufacturer = fru.at("Manufacturer");
                 uint32_t cpldDeviceN = fru.at("CPLDDeviceNo");
                 std::string invpath = baseinvInvPath + id;
-                for (auto& it : deviceIds)
-                {
-                    auto& pair = it.second;
-                    if (get<0>(pair) == model && get<1>(pair) == manufacturer)
-                    {
-                        get<2>(pair) = id;
-                        break;
-                    }
-                }
+                deviceIds.setDeviceId(model, manufacturer, id);
                 uint8_t busId = std::stoi(busN);
                 uint8_t devAddr = std::stoi(address, nullptr, 16);
 
-                auto invMatch = std::find_if(
-                    invs.begin(), invs.end(), [&invpath](auto& inv) {
-                        return inv->getInventoryPath() == invpath;
-                    });
-                if (invMatch != invs.end())
+                if (invs.contains(invpath))
                 {
                     continue;
                 }
                 auto inv = std::make_unique<CPLDDevice>(
                     invpath, busId, devAddr, imageselect, id, model,
                     manufacturer, cpldDeviceN);
-                invs.emplace_back(std::move(inv));
+                invs.add(id, busId, devAddr, std::move(inv));
             }
             catch (const std::exception& e)
             {
@@ -228,6 +259,24 @@ class CPLDItemUpdater : public BaseItemUpdater
      */
     std::string getModel(const std::string& inventoryPath) const override;
 
+    /**
+     * @brief Reads version, model and manufacturer of the device in one pass,
+     *        all of them come from cpld_config.json and need no bus access
+     *
+     * @param inventoryPath
+     * @return DeviceSnapshot
+     */
+    DeviceSnapshot readDeviceSnapshot(const std::string& inventoryPath) override;
+
+    /**
+     * @brief Get the I2C bus of the device
+     *
+     * @param inventoryPath
+     * @return std::optional<uint32_t>
+     */
+    std::optional<uint32_t>
+        getDeviceBus(const std::string& inventoryPath) const override;
+
     /**
      * @brief Get the Service Args object
      *
@@ -245,30 +294,25 @@ class CPLDItemUpdater : public BaseItemUpdater
 
         // The systemd unit shall be escaped
         std::string args = "";
-        for (auto& inv : invs)
+        if (auto inv = invs.findByPath(inventoryPath))
         {
-            if (inv->getInventoryPath() == inventoryPath)
-            {
-                args += "\\x20";
-                args += inv->getBusNum(); // <Bus-Number>
-                args += "\\x20";
-                args +=
-                    inv->getImageSelect(); /* <Image-Select> As per Nvidia
-                          Doc, Image-select = 2/0 (MID/MB): will flash image in
-                              CFM0(0xfbcfffff) backup,
-                          Image-select = 3/1 (MID/MB): will
-                              flash image in CFM1(0xfcbfffff) and
-                              CFM2(0xfcafffff) By default it was select as 3*/
-                args += "\\x20";
-                args += imagePath;
-                args += "\\x20";
-                args += inv->getCPLDDeviceNum();
-                args += "\\x20";
-                args += version; // for Message Registry
-                args += "\\x20";
-                args += configFile;
-                break;
-            }
+            args += "\\x20";
+            args += inv->getBusNum(); // <Bus-Number>
+            args += "\\x20";
+            args += inv->getImageSelect(); /* <Image-Select> As per Nvidia
+                      Doc, Image-select = 2/0 (MID/MB): will flash image in
+                          CFM0(0xfbcfffff) backup,
+                      Image-select = 3/1 (MID/MB): will
+                          flash image in CFM1(0xfcbfffff) and
+                          CFM2(0xfcafffff) By default it was select as 3*/
+            args += "\\x20";
+            args += imagePath;
+            args += "\\x20";
+            args += inv->getCPLDDeviceNum();
+            args += "\\x20";
+            args += version; // for Message Registry
+            args += "\\x20";
+            args += configFile;
         }
 
         std::replace(args.begin(), args.end(), '/', '-');
@@ -278,37 +322,25 @@ class CPLDItemUpdater : public BaseItemUpdater
 
     bool pathIsValidDevice(std::string& p)
     {
-        for (auto& inv : invs)
-        {
-            if (inv->getInventoryPath() == p)
-            {
-                return true;
-            }
-        }
-        return false;
+        return invs.contains(p);
     }
 
     std::string getIdProperty(const std::string& identifier) override
     {
-            std::string deviceVersion;
-            for (auto& it : deviceIds)
-            {
-                auto& pair = it.second;
-                if (it.first == identifier)
-                {
-                    deviceVersion = get<2>(pair);
-                    break;
-                }
-                if (get<2>(pair) == identifier)
-                {
-                    deviceVersion = identifier;
-                    break;
-                }
-            }
+        // identifier is either a UUID or a device ID
+        std::string deviceVersion;
+        if (auto entry = deviceIds.find(identifier))
+        {
+            deviceVersion = entry->deviceId;
+        }
+        else if (!deviceIds.findUUIDByDeviceId(identifier).empty())
+        {
+            deviceVersion = identifier;
+        }
 
-            if (deviceVersion.empty())
-                return "";
-            return createVersionID(getName(), deviceVersion);
+        if (deviceVersion.empty())
+            return "";
+        return createVersionID(getName(), deviceVersion);
     }
 
   private:
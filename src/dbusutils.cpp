@@ -50,10 +50,172 @@ using namespace phosphor::logging;
 // See details in https://gcc.gnu.org/bugzilla/show_bug.cgi?id=90415
 using std::experimental::any;
 using std::experimental::any_cast;
-using PropertyType = std::variant<std::string, bool>;
+
+// Retry policy of getServicesAsync, same number of attempts as getServices
+constexpr int mapperMaxRetry = 10;
+constexpr auto mapperInitialBackoff = std::chrono::milliseconds(100);
+constexpr auto mapperMaxBackoff = std::chrono::milliseconds(1000);
+// Time the mapper is given to introspect a service that claimed its name
+constexpr auto mapperSettleTime = std::chrono::seconds(10);
+
+MapperCache::MapperCache(sdbusplus::bus::bus& bus) :
+    interfacesAddedMatch(
+        bus, sdbusplus::bus::match::rules::interfacesAdded(),
+        std::bind(std::mem_fn(&MapperCache::onInterfacesChanged), this,
+                  std::placeholders::_1)),
+    interfacesRemovedMatch(
+        bus, sdbusplus::bus::match::rules::interfacesRemoved(),
+        std::bind(std::mem_fn(&MapperCache::onInterfacesChanged), this,
+                  std::placeholders::_1)),
+    nameOwnerChangedMatch(
+        bus, sdbusplus::bus::match::rules::nameOwnerChanged(),
+        std::bind(std::mem_fn(&MapperCache::onNameOwnerChanged), this,
+                  std::placeholders::_1))
+{}
+
+std::shared_ptr<MapperCache> MapperCache::instance(sdbusplus::bus::bus& bus)
+{
+    static std::map<sd_bus*, std::weak_ptr<MapperCache>> caches;
+    auto& cache = caches[bus.get()];
+    auto ret = cache.lock();
+    if (!ret)
+    {
+        ret = std::make_shared<MapperCache>(bus);
+        cache = ret;
+    }
+    return ret;
+}
+
+const std::vector<std::string>*
+    MapperCache::findEntry(std::map<Key, Entry>& entries, const Key& key)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+    {
+        return nullptr;
+    }
+    if (Clock::now() >= it->second.expiresAt)
+    {
+        entries.erase(it);
+        return nullptr;
+    }
+    return &it->second.value;
+}
+
+MapperCache::Clock::time_point MapperCache::expiryTime() const
+{
+    auto now = Clock::now();
+    auto settled = lastOwnerChange + mapperSettleTime;
+    if (now < settled)
+    {
+        // The reply may miss objects of the new owner not introspected yet
+        return settled;
+    }
+    return now + std::chrono::seconds(MAPPER_CACHE_TTL);
+}
+
+const std::vector<std::string>*
+    MapperCache::findServices(const std::string& path,
+                              const std::string& interface)
+{
+    return findEntry(services, {path, interface});
+}
+
+void MapperCache::storeServices(const std::string& path,
+                                const std::string& interface,
+                                const std::vector<std::string>& serviceNames)
+{
+    services[{path, interface}] = {serviceNames, expiryTime()};
+}
+
+const std::vector<std::string>*
+    MapperCache::findSubTreePaths(const std::string& root,
+                                  const std::string& interface)
+{
+    return findEntry(subTreePaths, {root, interface});
+}
+
+void MapperCache::storeSubTreePaths(const std::string& root,
+                                    const std::string& interface,
+                                    const std::vector<std::string>& paths)
+{
+    subTreePaths[{root, interface}] = {paths, expiryTime()};
+}
+
+void MapperCache::invalidate(const std::string& path)
+{
+    // The services of the object itself
+    auto it = services.lower_bound({path, ""});
+    while (it != services.end() && it->first.first == path)
+    {
+        it = services.erase(it);
+    }
+    // Every subtree the object belongs to
+    for (auto st = subTreePaths.begin(); st != subTreePaths.end();)
+    {
+        const auto& root = st->first.first;
+        if (path.starts_with(root) &&
+            (path.size() == root.size() || path[root.size()] == '/'))
+        {
+            st = subTreePaths.erase(st);
+        }
+        else
+        {
+            st++;
+        }
+    }
+}
+
+void MapperCache::clear()
+{
+    services.clear();
+    subTreePaths.clear();
+}
+
+void MapperCache::onInterfacesChanged(sdbusplus::message::message& msg)
+{
+    try
+    {
+        sdbusplus::message::object_path objPath;
+        msg.read(objPath);
+        invalidate(objPath.str);
+    }
+    catch (const std::exception& e)
+    {
+        // Not knowing what changed, nothing cached can be trusted
+        clear();
+    }
+}
+
+void MapperCache::onNameOwnerChanged(sdbusplus::message::message& msg)
+{
+    std::string name;
+    std::string oldOwner;
+    std::string newOwner;
+    try
+    {
+        msg.read(name, oldOwner, newOwner);
+    }
+    catch (const std::exception& e)
+    {
+        clear();
+        return;
+    }
+    // Unique names come and go with every client connection, the mapper
+    // replies carry well-known names only
+    if (!name.empty() && name.front() != ':')
+    {
+        lastOwnerChange = Clock::now();
+        clear();
+    }
+}
 
 std::vector<std::string> DBUSUtils::getinventoryPath(const std::string& iface)
 {
+    if (auto cached = mapperCache->findSubTreePaths(INVENTORY_PATH_BASE, iface))
+    {
+        return *cached;
+    }
     std::vector<std::string> paths;
     auto method = bus.new_method_call(MAPPER_BUSNAME, MAPPER_PATH,
                                       MAPPER_INTERFACE, "GetSubTreePaths");
@@ -63,9 +225,50 @@ std::vector<std::string> DBUSUtils::getinventoryPath(const std::string& iface)
     auto reply = bus.call(method);
 
     reply.read(paths);
+    mapperCache->storeSubTreePaths(INVENTORY_PATH_BASE, iface, paths);
     return paths;
 }
 
+void DBUSUtils::getinventoryPathAsync(const std::string& iface,
+                                      PathsCallback callback)
+{
+    if (auto cached = mapperCache->findSubTreePaths(INVENTORY_PATH_BASE, iface))
+    {
+        // Still reply from the event loop like a D-Bus reply would
+        callAfter(std::chrono::milliseconds(0),
+                  [paths = *cached, callback = std::move(callback)]() {
+                      callback(paths);
+                  });
+        return;
+    }
+    auto method = bus.new_method_call(MAPPER_BUSNAME, MAPPER_PATH,
+                                      MAPPER_INTERFACE, "GetSubTreePaths");
+    method.append(INVENTORY_PATH_BASE);
+    method.append(0); // Depth 0 to search all
+    method.append(std::vector<std::string>({iface}));
+    callAsync(method, [this, iface, callback = std::move(callback)](
+                          sdbusplus::message::message& reply) {
+        std::vector<std::string> paths;
+        try
+        {
+            if (reply.is_method_error())
+            {
+                throw std::runtime_error("GetSubTreePaths call failed");
+            }
+            reply.read(paths);
+            mapperCache->storeSubTreePaths(INVENTORY_PATH_BASE, iface, paths);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("Error reading inventory paths",
+                            entry("INTERFACE=%s", iface.c_str()),
+                            entry("ERROR=%s", e.what()));
+            paths.clear();
+        }
+        callback(std::move(paths));
+    });
+}
+
 std::string DBUSUtils::createVersionID(const std::string& updaterName,
                                        const std::string& version)
 {
@@ -125,9 +328,100 @@ any DBUSUtils::getPropertyImpl(const char* service, const char* path,
     }
 }
 
+Properties DBUSUtils::getAllProperties(const char* service, const char* path,
+                                       const char* interface) const
+{
+    auto method = bus.new_method_call(
+        service, path, "org.freedesktop.DBus.Properties", "GetAll");
+    method.append(interface);
+    try
+    {
+        Properties properties;
+        auto reply = bus.call(method);
+        reply.read(properties);
+        return properties;
+    }
+    catch (const sdbusplus::exception::SdBusError& ex)
+    {
+        log<level::ERR>("GetAll call failed", entry("PATH=%s", path),
+                        entry("INTERFACE=%s", interface));
+        throw std::runtime_error("GetAll call failed");
+    }
+}
+
+void DBUSUtils::getAllPropertiesAsync(const std::string& service,
+                                      const std::string& path,
+                                      const std::string& interface,
+                                      PropertiesCallback callback)
+{
+    auto method = bus.new_method_call(
+        service.c_str(), path.c_str(), "org.freedesktop.DBus.Properties",
+        "GetAll");
+    method.append(interface);
+    callAsync(method, [path, interface, callback = std::move(callback)](
+                          sdbusplus::message::message& reply) {
+        try
+        {
+            if (reply.is_method_error())
+            {
+                throw std::runtime_error("GetAll call failed");
+            }
+            Properties properties;
+            reply.read(properties);
+            callback(std::move(properties));
+            return;
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("GetAll call failed",
+                            entry("PATH=%s", path.c_str()),
+                            entry("INTERFACE=%s", interface.c_str()));
+        }
+        callback(std::nullopt);
+    });
+}
+
+void DBUSUtils::getPropertyImplAsync(const std::string& service,
+                                     const std::string& path,
+                                     const std::string& interface,
+                                     const std::string& propertyName,
+                                     PropertyCallback callback)
+{
+    auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                      "org.freedesktop.DBus.Properties", "Get");
+    method.append(interface, propertyName);
+    callAsync(method, [path, interface, propertyName,
+                       callback = std::move(callback)](
+                          sdbusplus::message::message& reply) {
+        try
+        {
+            if (reply.is_method_error())
+            {
+                throw std::runtime_error("GetProperty call failed");
+            }
+            PropertyType value{};
+            reply.read(value);
+            callback(value);
+            return;
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("GetProperty call failed",
+                            entry("PATH=%s", path.c_str()),
+                            entry("INTERFACE=%s", interface.c_str()),
+                            entry("PROPERTY=%s", propertyName.c_str()));
+        }
+        callback(std::nullopt);
+    });
+}
+
 std::vector<std::string> DBUSUtils::getServices(const char* path,
                                                 const char* interface)
 {
+    if (auto cached = mapperCache->findServices(path, interface))
+    {
+        return *cached;
+    }
     auto mapper = bus.new_method_call(MAPPER_BUSNAME, MAPPER_PATH,
                                       MAPPER_INTERFACE, "GetObject");
 
@@ -153,6 +447,7 @@ std::vector<std::string> DBUSUtils::getServices(const char* path,
             {
                 ret.emplace_back(i.first);
             }
+            mapperCache->storeServices(path, interface, ret);
             return ret;
         }
         catch (const sdbusplus::exception::SdBusError& ex)
@@ -172,6 +467,78 @@ std::vector<std::string> DBUSUtils::getServices(const char* path,
     return {};
 }
 
+void DBUSUtils::getServicesAsync(const std::string& path,
+                                 const std::string& interface,
+                                 PathsCallback callback)
+{
+    if (auto cached = mapperCache->findServices(path, interface))
+    {
+        callAfter(std::chrono::milliseconds(0),
+                  [services = *cached, callback = std::move(callback)]() {
+                      callback(services);
+                  });
+        return;
+    }
+    getServicesAttempt(path, interface, std::move(callback), 0);
+}
+
+void DBUSUtils::getServicesAttempt(const std::string& path,
+                                   const std::string& interface,
+                                   PathsCallback callback, int retry)
+{
+    auto mapper = bus.new_method_call(MAPPER_BUSNAME, MAPPER_PATH,
+                                      MAPPER_INTERFACE, "GetObject");
+    mapper.append(path, std::vector<std::string>({interface}));
+    callAsync(mapper, [this, path, interface, retry,
+                       callback = std::move(callback)](
+                          sdbusplus::message::message& reply) mutable {
+        try
+        {
+            if (reply.is_method_error())
+            {
+                throw std::runtime_error("GetObject call failed");
+            }
+            std::vector<std::pair<std::string, std::vector<std::string>>>
+                mapperResponse;
+            reply.read(mapperResponse);
+            if (mapperResponse.empty())
+            {
+                throw std::runtime_error("Error reading mapper response");
+            }
+            std::vector<std::string> ret;
+            for (const auto& i : mapperResponse)
+            {
+                ret.emplace_back(i.first);
+            }
+            mapperCache->storeServices(path, interface, ret);
+            callback(std::move(ret));
+            return;
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("GetObject call failed",
+                            entry("PATH=%s", path.c_str()),
+                            entry("INTERFACE=%s", interface.c_str()),
+                            entry("ERROR=%s", e.what()));
+        }
+        if (retry + 1 >= mapperMaxRetry)
+        {
+            log<level::ERR>("Retry attempts exhausted, GetObject call failed",
+                            entry("PATH=%s", path.c_str()));
+            callback({});
+            return;
+        }
+        // Back off without blocking, the mapper may still be populating
+        auto backoff = std::min<std::chrono::milliseconds>(
+            mapperInitialBackoff * (1 << retry), mapperMaxBackoff);
+        callAfter(backoff, [this, path, interface, retry,
+                            callback = std::move(callback)]() mutable {
+            getServicesAttempt(path, interface, std::move(callback),
+                               retry + 1);
+        });
+    });
+}
+
 std::string DBUSUtils::getService(const char* path, const char* interface)
 {
     auto services = getServices(path, interface);
@@ -184,6 +551,11 @@ std::string DBUSUtils::getService(const char* path, const char* interface)
 
 std::vector<std::string> DBUSUtils::getSoftwareObjects()
 {
+    if (auto cached =
+            mapperCache->findSubTreePaths(SOFTWARE_OBJPATH, VERSION_IFACE))
+    {
+        return *cached;
+    }
     std::vector<std::string> paths;
     auto method = bus.new_method_call(MAPPER_BUSNAME, MAPPER_PATH,
                                       MAPPER_INTERFACE, "GetSubTreePaths");
@@ -192,9 +564,54 @@ std::vector<std::string> DBUSUtils::getSoftwareObjects()
     method.append(std::vector<std::string>({VERSION_IFACE}));
     auto reply = bus.call(method);
     reply.read(paths);
+    mapperCache->storeSubTreePaths(SOFTWARE_OBJPATH, VERSION_IFACE, paths);
     return paths;
 }
 
+void DBUSUtils::callAsync(
+    sdbusplus::message::message& method,
+    std::function<void(sdbusplus::message::message&)> handler)
+{
+    auto id = nextAsyncId++;
+    pendingCalls.emplace(
+        id, bus.call_async(method, [this, id, handler = std::move(handler)](
+                                       sdbusplus::message::message& reply) {
+            retireAsync(id);
+            handler(reply);
+        }));
+}
+
+void DBUSUtils::callAfter(std::chrono::milliseconds delay,
+                          std::function<void()> handler)
+{
+    auto id = nextAsyncId++;
+    auto timer = std::make_unique<sdbusplus::Timer>(
+        [this, id, handler = std::move(handler)]() {
+            retireAsync(id);
+            handler();
+        });
+    timer->start(delay);
+    pendingTimers.emplace(id, std::move(timer));
+}
+
+void DBUSUtils::retireAsync(uint64_t id)
+{
+    retiredCalls.clear();
+    retiredTimers.clear();
+    auto call = pendingCalls.find(id);
+    if (call != pendingCalls.end())
+    {
+        retiredCalls.emplace_back(std::move(call->second));
+        pendingCalls.erase(call);
+    }
+    auto timer = pendingTimers.find(id);
+    if (timer != pendingTimers.end())
+    {
+        retiredTimers.emplace_back(std::move(timer->second));
+        pendingTimers.erase(timer);
+    }
+}
+
 bool DBUSUtils::findSoftwareObject(std::string& objPath)
 {
     auto allSoftwareObjs = getSoftwareObjects();
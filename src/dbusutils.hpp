@@ -17,6 +17,7 @@
 
 
 #pragma once
+#include "signal_router.hpp"
 #include "watch.hpp"
 
 #include <openssl/sha.h>
@@ -28,11 +29,19 @@
 
 #include <phosphor-logging/elog.hpp>
 #include <phosphor-logging/log.hpp>
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/timer.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <experimental/any>
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 
 namespace nvidia
@@ -46,7 +55,179 @@ namespace updater
 // See details in https://gcc.gnu.org/bugzilla/show_bug.cgi?id=90415
 using std::experimental::any;
 using std::experimental::any_cast;
-using PropertyType = std::variant<std::string, bool>;
+using PropertyType =
+    std::variant<std::string, bool, uint8_t, uint16_t, int16_t, uint32_t,
+                 int32_t, uint64_t, int64_t, double, std::vector<std::string>>;
+using Properties = std::map<std::string, PropertyType>;
+using PathsCallback = std::function<void(std::vector<std::string>)>;
+using PropertyCallback = std::function<void(std::optional<PropertyType>)>;
+using PropertiesCallback = std::function<void(std::optional<Properties>)>;
+
+/**
+ * @brief Find a property of type T in a property map
+ *
+ * @tparam T
+ * @param properties
+ * @param propertyName
+ * @return std::optional<T> - std::nullopt if missing or of other type
+ */
+template <typename T>
+std::optional<T> findProperty(const Properties& properties,
+                              const std::string& propertyName)
+{
+    auto it = properties.find(propertyName);
+    if (it != properties.end())
+    {
+        if (auto value = std::get_if<T>(&it->second))
+        {
+            return *value;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Cache of ObjectMapper replies shared by all DBUSUtils of a bus. An
+ * entry is dropped when interfaces are added to or removed from its path,
+ * everything is dropped when a well-known bus name changes its owner. Only
+ * successful lookups are cached, and an entry expires after
+ * MAPPER_CACHE_TTL seconds. A reply stored while the mapper may still be
+ * introspecting a service that just claimed its name expires as soon as
+ * the mapper had time to settle.
+ */
+class MapperCache
+{
+  public:
+    using Key = std::pair<std::string, std::string>;
+
+    MapperCache(const MapperCache&) = delete;
+    MapperCache& operator=(const MapperCache&) = delete;
+
+    /**
+     * @brief Construct a new Mapper Cache object and subscribe to the
+     * invalidating signals
+     *
+     * @param bus
+     */
+    MapperCache(sdbusplus::bus::bus& bus);
+
+    /**
+     * @brief Get the cache shared by all users of the bus
+     *
+     * @param bus
+     * @return std::shared_ptr<MapperCache>
+     */
+    static std::shared_ptr<MapperCache> instance(sdbusplus::bus::bus& bus);
+
+    /**
+     * @brief Find the cached GetObject services of path and interface
+     *
+     * @param path
+     * @param interface
+     * @return const std::vector<std::string>* - nullptr if not cached
+     */
+    const std::vector<std::string>* findServices(const std::string& path,
+                                                 const std::string& interface);
+
+    /**
+     * @brief Cache the GetObject services of path and interface
+     *
+     * @param path
+     * @param interface
+     * @param serviceNames
+     */
+    void storeServices(const std::string& path, const std::string& interface,
+                       const std::vector<std::string>& serviceNames);
+
+    /**
+     * @brief Find the cached GetSubTreePaths reply of root and interface
+     *
+     * @param root
+     * @param interface
+     * @return const std::vector<std::string>* - nullptr if not cached
+     */
+    const std::vector<std::string>*
+        findSubTreePaths(const std::string& root, const std::string& interface);
+
+    /**
+     * @brief Cache the GetSubTreePaths reply of root and interface
+     *
+     * @param root
+     * @param interface
+     * @param paths
+     */
+    void storeSubTreePaths(const std::string& root,
+                           const std::string& interface,
+                           const std::vector<std::string>& paths);
+
+    /**
+     * @brief Drop the entries affected by a change of the object at path
+     *
+     * @param path
+     */
+    void invalidate(const std::string& path);
+
+    /**
+     * @brief Drop all entries
+     *
+     */
+    void clear();
+
+  private:
+    /**
+     * @brief InterfacesAdded and InterfacesRemoved signal handler
+     *
+     * @param msg
+     */
+    void onInterfacesChanged(sdbusplus::message::message& msg);
+
+    /**
+     * @brief NameOwnerChanged signal handler
+     *
+     * @param msg
+     */
+    void onNameOwnerChanged(sdbusplus::message::message& msg);
+
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief cached reply and the time it is no longer trusted */
+    struct Entry
+    {
+        std::vector<std::string> value;
+        Clock::time_point expiresAt;
+    };
+
+    /**
+     * @brief Find an entry that has not expired yet, an expired entry is
+     * dropped
+     *
+     * @param entries
+     * @param key
+     * @return const std::vector<std::string>* - nullptr if not cached
+     */
+    static const std::vector<std::string>*
+        findEntry(std::map<Key, Entry>& entries, const Key& key);
+
+    /**
+     * @brief Get the expiry time of a reply received now
+     *
+     * @return Clock::time_point
+     */
+    Clock::time_point expiryTime() const;
+
+    std::map<Key, Entry> services;
+
+    std::map<Key, Entry> subTreePaths;
+
+    /** @brief last time a well-known name changed its owner */
+    Clock::time_point lastOwnerChange{};
+
+    sdbusplus::bus::match_t interfacesAddedMatch;
+
+    sdbusplus::bus::match_t interfacesRemovedMatch;
+
+    sdbusplus::bus::match_t nameOwnerChangedMatch;
+};
 
 /**
  * @brief
@@ -62,7 +243,9 @@ class DBUSUtils
      *
      * @param bus
      */
-    DBUSUtils(sdbusplus::bus::bus& bus) : bus(bus)
+    DBUSUtils(sdbusplus::bus::bus& bus) :
+        bus(bus), mapperCache(MapperCache::instance(bus)),
+        signalRouter(SignalRouter::instance(bus))
     {}
     /**
      * @brief get inventory objects of interface
@@ -72,6 +255,16 @@ class DBUSUtils
      */
     std::vector<std::string> getinventoryPath(const std::string& iface);
 
+    /**
+     * @brief get inventory objects of interface without blocking the event
+     * loop, callback gets an empty list on failure
+     *
+     * @param iface
+     * @param callback
+     */
+    void getinventoryPathAsync(const std::string& iface,
+                               PathsCallback callback);
+
     /**
      * @brief Create a Version ID object
      *
@@ -113,6 +306,78 @@ class DBUSUtils
         return std::get<T>(value);
     }
 
+    /**
+     * @brief Get all properties of the interface in one GetAll call
+     *
+     * @param service
+     * @param path
+     * @param interface
+     * @return Properties
+     */
+    Properties getAllProperties(const char* service, const char* path,
+                                const char* interface) const;
+
+    /**
+     * @brief Get all properties of the interface in one GetAll call without
+     * blocking the event loop, callback gets std::nullopt on failure
+     *
+     * @param service
+     * @param path
+     * @param interface
+     * @param callback
+     */
+    void getAllPropertiesAsync(const std::string& service,
+                               const std::string& path,
+                               const std::string& interface,
+                               PropertiesCallback callback);
+
+    /**
+     * @brief Get the Property Impl object without blocking the event loop,
+     * callback gets std::nullopt on failure
+     *
+     * @param service
+     * @param path
+     * @param interface
+     * @param propertyName
+     * @param callback
+     */
+    void getPropertyImplAsync(const std::string& service,
+                              const std::string& path,
+                              const std::string& interface,
+                              const std::string& propertyName,
+                              PropertyCallback callback);
+
+    /**
+     * @brief Get the Property object without blocking the event loop
+     *
+     * @tparam T
+     * @param service
+     * @param path
+     * @param interface
+     * @param propertyName
+     * @param callback - gets std::nullopt on failure or type mismatch
+     */
+    template <typename T>
+    void getPropertyAsync(const std::string& service, const std::string& path,
+                          const std::string& interface,
+                          const std::string& propertyName,
+                          std::function<void(std::optional<T>)> callback)
+    {
+        getPropertyImplAsync(
+            service, path, interface, propertyName,
+            [callback = std::move(callback)](std::optional<PropertyType> value) {
+                if (value)
+                {
+                    if (auto p = std::get_if<T>(&*value))
+                    {
+                        callback(*p);
+                        return;
+                    }
+                }
+                callback(std::nullopt);
+            });
+    }
+
     /**
      * @brief Get the Services object
      *
@@ -122,6 +387,19 @@ class DBUSUtils
      */
     std::vector<std::string> getServices(const char* path,
                                          const char* interface);
+
+    /**
+     * @brief Get the Services object without blocking the event loop. Failed
+     * mapper calls are retried on an sd_event timer with backoff, callback
+     * gets an empty list once the retries are exhausted
+     *
+     * @param path
+     * @param interface
+     * @param callback
+     */
+    void getServicesAsync(const std::string& path,
+                          const std::string& interface,
+                          PathsCallback callback);
     /**
      * @brief Get the Service object
      *
@@ -150,6 +428,57 @@ class DBUSUtils
   protected:
     sdbusplus::bus::bus& bus;
 
+    std::shared_ptr<MapperCache> mapperCache;
+
+    std::shared_ptr<SignalRouter> signalRouter;
+
+    /**
+     * @brief Sends the method call asynchronously, the pending call is owned
+     * by this object and cancelled on destruction
+     *
+     * @param method
+     * @param handler - called with the reply or the error reply
+     */
+    void callAsync(sdbusplus::message::message& method,
+                   std::function<void(sdbusplus::message::message&)> handler);
+
+    /**
+     * @brief Calls handler from the event loop after delay
+     *
+     * @param delay
+     * @param handler
+     */
+    void callAfter(std::chrono::milliseconds delay,
+                   std::function<void()> handler);
+
+  private:
+    /**
+     * @brief One GetObject attempt of getServicesAsync
+     *
+     * @param path
+     * @param interface
+     * @param callback
+     * @param retry - attempts done so far
+     */
+    void getServicesAttempt(const std::string& path,
+                            const std::string& interface,
+                            PathsCallback callback, int retry);
+
+    /**
+     * @brief Moves a completed call or timer out of the pending maps. It can
+     * not be destroyed from within its own callback, so it is kept until the
+     * next completion
+     *
+     * @param id
+     */
+    void retireAsync(uint64_t id);
+
+    uint64_t nextAsyncId = 0;
+    std::map<uint64_t, sdbusplus::slot::slot> pendingCalls;
+    std::map<uint64_t, std::unique_ptr<sdbusplus::Timer>> pendingTimers;
+    std::vector<sdbusplus::slot::slot> retiredCalls;
+    std::vector<std::unique_ptr<sdbusplus::Timer>> retiredTimers;
+
 }; // DBUSUtils
 } // namespace updater
 } // namespace software
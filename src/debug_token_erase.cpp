@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "debug_token_erase.hpp"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -44,6 +45,33 @@ std::string DebugTokenEraseItemUpdater::getModel([
 {
     return "";
 }
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    try
+    {
+        return std::make_unique<DebugTokenEraseItemUpdater>(bus);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Debug token object exception",
+                        entry("TOKEN_EXCEPTION=%s", e.what()));
+        throw;
+    }
+}
+} // namespace
+
+constexpr UpdaterDescriptor debugTokenEraseUpdater = {
+    .name = "DebugTokenErase",
+    .busName = DEBUG_TOKEN_ERASE_BUSNAME_UPDATER,
+    .service = DEBUG_TOKEN_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
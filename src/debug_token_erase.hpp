@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <sstream>
 
@@ -49,8 +50,9 @@ class DebugTokenEraseItemUpdater : public BaseItemUpdater
     DebugTokenEraseItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(
             bus, DEBUG_TOKEN_ERASE_SUPPORTED_MODEL, DEBUG_TOKEN_INVENTORY_IFACE,
-            DEBUG_TOKEN_ERASE_NAME, DEBUG_TOKEN_ERASE_BUSNAME_UPDATER,
-            DEBUG_TOKEN_UPDATE_SERVICE, false, DEBUG_TOKEN_BUSNAME_INVENTORY)
+            DEBUG_TOKEN_ERASE_NAME, std::string(debugTokenEraseUpdater.busName),
+            std::string(debugTokenEraseUpdater.service), false,
+            DEBUG_TOKEN_BUSNAME_INVENTORY)
     {}
     /**
      * @brief Get the Version
@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "debug_token_install.hpp"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -44,6 +45,33 @@ std::string DebugTokenInstallItemUpdater::getModel([
 {
     return "";
 }
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    try
+    {
+        return std::make_unique<DebugTokenInstallItemUpdater>(bus);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Debug token object exception",
+                        entry("TOKEN_EXCEPTION=%s", e.what()));
+        throw;
+    }
+}
+} // namespace
+
+constexpr UpdaterDescriptor debugTokenInstallUpdater = {
+    .name = "DebugTokenInstall",
+    .busName = DEBUG_TOKEN_INSTALL_BUSNAME_UPDATER,
+    .service = DEBUG_TOKEN_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
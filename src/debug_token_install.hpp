@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <sstream>
 
@@ -49,8 +50,8 @@ class DebugTokenInstallItemUpdater : public BaseItemUpdater
     DebugTokenInstallItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(bus, DEBUG_TOKEN_INSTALL_SUPPORTED_MODEL,
                         DEBUG_TOKEN_INVENTORY_IFACE, DEBUG_TOKEN_INSTALL_NAME,
-                        DEBUG_TOKEN_INSTALL_BUSNAME_UPDATER,
-                        DEBUG_TOKEN_UPDATE_SERVICE, false,
+                        std::string(debugTokenInstallUpdater.busName),
+                        std::string(debugTokenInstallUpdater.service), false,
                         DEBUG_TOKEN_BUSNAME_INVENTORY)
     {}
     /**
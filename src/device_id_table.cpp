@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_id_table.hpp"
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+bool DeviceIdTable::insert(const std::string& uuid, const std::string& model,
+                           const std::string& manufacturer)
+{
+    if (!entries.emplace(uuid, Entry{model, manufacturer, ""}).second)
+    {
+        return false;
+    }
+    byModel[{model, manufacturer}].insert(uuid);
+    return true;
+}
+
+bool DeviceIdTable::erase(const std::string& uuid)
+{
+    auto it = entries.find(uuid);
+    if (it == entries.end())
+    {
+        return false;
+    }
+    auto& entry = it->second;
+    auto models = byModel.find({entry.model, entry.manufacturer});
+    if (models != byModel.end())
+    {
+        models->second.erase(uuid);
+        if (models->second.empty())
+        {
+            byModel.erase(models);
+        }
+    }
+    auto ids = byDeviceId.find(entry.deviceId);
+    if (ids != byDeviceId.end())
+    {
+        ids->second.erase(uuid);
+        if (ids->second.empty())
+        {
+            byDeviceId.erase(ids);
+        }
+    }
+    entries.erase(it);
+    return true;
+}
+
+const DeviceIdTable::Entry* DeviceIdTable::find(const std::string& uuid) const
+{
+    auto it = entries.find(uuid);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+std::string DeviceIdTable::getUUID(const std::string& model,
+                                   const std::string& manufacturer) const
+{
+    auto it = byModel.find({model, manufacturer});
+    if (it != byModel.end() && !it->second.empty())
+    {
+        return *it->second.rbegin();
+    }
+    // use first uuid as default
+    return entries.empty() ? "" : entries.begin()->first;
+}
+
+void DeviceIdTable::setDeviceId(const std::string& model,
+                                const std::string& manufacturer,
+                                const std::string& deviceId)
+{
+    auto it = byModel.find({model, manufacturer});
+    if (it == byModel.end() || it->second.empty())
+    {
+        return;
+    }
+    const auto& uuid = *it->second.begin();
+    auto& entry = entries.at(uuid);
+    if (!entry.deviceId.empty())
+    {
+        auto ids = byDeviceId.find(entry.deviceId);
+        if (ids != byDeviceId.end())
+        {
+            ids->second.erase(uuid);
+            if (ids->second.empty())
+            {
+                byDeviceId.erase(ids);
+            }
+        }
+    }
+    entry.deviceId = deviceId;
+    byDeviceId[deviceId].insert(uuid);
+}
+
+std::string DeviceIdTable::findUUIDByDeviceId(const std::string& deviceId) const
+{
+    auto it = byDeviceId.find(deviceId);
+    if (it == byDeviceId.end() || it->second.empty())
+    {
+        return "";
+    }
+    return *it->second.begin();
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
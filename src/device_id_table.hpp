@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class DeviceIdTable
+ *
+ *  @brief Supported devices of an item updater keyed by UUID, built from the
+ *         <Manufacture>:<Model>:<UUID> configuration. Secondary hash indexes
+ *         resolve the UUID of a model/manufacturer and of a device ID
+ *         without walking the table.
+ */
+class DeviceIdTable
+{
+  public:
+    struct Entry
+    {
+        std::string model;
+        std::string manufacturer;
+        /** @brief device ID assigned by the updater, empty if none */
+        std::string deviceId;
+    };
+
+    using const_iterator = std::map<std::string, Entry>::const_iterator;
+
+    /**
+     * @brief Adds a UUID, an already known UUID is left unchanged
+     *
+     * @param uuid
+     * @param model
+     * @param manufacturer
+     * @return true if the UUID was added
+     */
+    bool insert(const std::string& uuid, const std::string& model,
+                const std::string& manufacturer);
+
+    /**
+     * @brief Removes a UUID
+     *
+     * @param uuid
+     * @return true if the UUID was known
+     */
+    bool erase(const std::string& uuid);
+
+    /**
+     * @brief Find the entry of a UUID
+     *
+     * @param uuid
+     * @return const Entry* - nullptr if unknown
+     */
+    const Entry* find(const std::string& uuid) const;
+
+    bool contains(const std::string& uuid) const
+    {
+        return entries.contains(uuid);
+    }
+
+    /**
+     * @brief Get the UUID of a model and manufacturer. If several UUIDs
+     * match the greatest one is returned. Without any match the first UUID
+     * is the default, this is to allow update even if the inventory reports
+     * a model mismatch
+     *
+     * @param model
+     * @param manufacturer
+     * @return std::string - empty if the table is empty
+     */
+    std::string getUUID(const std::string& model,
+                        const std::string& manufacturer) const;
+
+    /**
+     * @brief Assigns the device ID to the first UUID of the model and
+     * manufacturer
+     *
+     * @param model
+     * @param manufacturer
+     * @param deviceId
+     */
+    void setDeviceId(const std::string& model, const std::string& manufacturer,
+                     const std::string& deviceId);
+
+    /**
+     * @brief Find the first UUID a device ID is assigned to
+     *
+     * @param deviceId
+     * @return std::string - empty if not assigned
+     */
+    std::string findUUIDByDeviceId(const std::string& deviceId) const;
+
+    bool empty() const
+    {
+        return entries.empty();
+    }
+
+    const_iterator begin() const
+    {
+        return entries.begin();
+    }
+
+    const_iterator end() const
+    {
+        return entries.end();
+    }
+
+  private:
+    using ModelKey = std::pair<std::string, std::string>;
+
+    struct ModelKeyHash
+    {
+        size_t operator()(const ModelKey& key) const
+        {
+            auto seed = std::hash<std::string>{}(key.first);
+            return seed ^ (std::hash<std::string>{}(key.second) + 0x9e3779b9 +
+                           (seed << 6) + (seed >> 2));
+        }
+    };
+
+    /** @brief entries in UUID order, the order defines the default UUID */
+    std::map<std::string, Entry> entries;
+
+    /** @brief UUIDs of a model and manufacturer */
+    std::unordered_map<ModelKey, std::set<std::string>, ModelKeyHash> byModel;
+
+    /** @brief UUIDs of a device ID */
+    std::unordered_map<std::string, std::set<std::string>> byDeviceId;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
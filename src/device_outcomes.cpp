@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_outcomes.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+
+const sdbusplus::vtable_t DeviceOutcomes::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("Devices", "a{s(su)}",
+                                DeviceOutcomes::getDevices,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::end()};
+
+DeviceOutcomes::DeviceOutcomes(sdbusplus::bus::bus& bus,
+                               const std::string& objPath) :
+    serverInterface(bus, objPath.c_str(), interfaceName, vtable, this)
+{
+    serverInterface.emit_added();
+}
+
+std::optional<DeviceOutcome>
+    DeviceOutcomes::get(const std::string& device) const
+{
+    auto it = entries.find(device);
+    if (it == entries.end())
+    {
+        return std::nullopt;
+    }
+    return it->second.outcome;
+}
+
+void DeviceOutcomes::set(const std::string& device, DeviceOutcome outcome)
+{
+    auto [it, inserted] = entries.try_emplace(device, Entry{outcome});
+    if (!inserted && it->second.outcome == outcome)
+    {
+        return;
+    }
+    it->second.outcome = outcome;
+    serverInterface.property_changed("Devices");
+}
+
+std::vector<std::string> DeviceOutcomes::find(DeviceOutcome outcome) const
+{
+    std::vector<std::string> devices;
+    for (const auto& [device, e] : entries)
+    {
+        if (e.outcome == outcome)
+        {
+            devices.push_back(device);
+        }
+    }
+    return devices;
+}
+
+void DeviceOutcomes::addAttempt(const std::string& device)
+{
+    auto& e = entries[device];
+    e.outcome = DeviceOutcome::Updating;
+    e.attempts++;
+    serverInterface.property_changed("Devices");
+}
+
+uint32_t DeviceOutcomes::getAttempts(const std::string& device) const
+{
+    auto it = entries.find(device);
+    return it == entries.end() ? 0 : it->second.attempts;
+}
+
+void DeviceOutcomes::erase(const std::string& device)
+{
+    if (entries.erase(device))
+    {
+        serverInterface.property_changed("Devices");
+    }
+}
+
+void DeviceOutcomes::resume()
+{
+    std::erase_if(entries, [](const auto& item) {
+        return item.second.outcome != DeviceOutcome::Updated;
+    });
+    serverInterface.property_changed("Devices");
+}
+
+void DeviceOutcomes::clear()
+{
+    if (!entries.empty())
+    {
+        entries.clear();
+        serverInterface.property_changed("Devices");
+    }
+}
+
+bool DeviceOutcomes::anyFailed() const
+{
+    return std::any_of(entries.begin(), entries.end(), [](const auto& item) {
+        return item.second.outcome == DeviceOutcome::Failed;
+    });
+}
+
+const char* DeviceOutcomes::toString(DeviceOutcome outcome)
+{
+    switch (outcome)
+    {
+        case DeviceOutcome::Queued:
+            return "Queued";
+        case DeviceOutcome::Updating:
+            return "Updating";
+        case DeviceOutcome::Retrying:
+            return "Retrying";
+        case DeviceOutcome::Updated:
+            return "Updated";
+        case DeviceOutcome::Failed:
+            return "Failed";
+        case DeviceOutcome::Skipped:
+            return "Skipped";
+    }
+    return "Unknown";
+}
+
+int DeviceOutcomes::getDevices(sd_bus* /* bus */, const char* /* path */,
+                               const char* /* iface */,
+                               const char* /* property */,
+                               sd_bus_message* reply, void* context,
+                               sd_bus_error* /* error */)
+{
+    auto outcomes = static_cast<DeviceOutcomes*>(context);
+    std::map<std::string, std::tuple<std::string, uint32_t>> devices;
+    for (const auto& [device, e] : outcomes->entries)
+    {
+        devices.emplace(device, std::make_tuple(toString(e.outcome),
+                                                e.attempts));
+    }
+    try
+    {
+        sdbusplus::message::message m(reply);
+        m.append(devices);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Unable to reply device outcomes",
+                        entry("ERROR=%s", e.what()));
+        return -EINVAL;
+    }
+    return 1;
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,173 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/**
+ * @brief State of a device in the activation of a version
+ */
+enum class DeviceOutcome
+{
+    /** @brief waiting for a free update slot */
+    Queued,
+    /** @brief update service running */
+    Updating,
+    /** @brief last attempt failed, waiting to be tried again */
+    Retrying,
+    /** @brief runs the image */
+    Updated,
+    /** @brief all attempts failed */
+    Failed,
+    /** @brief left out, it already ran the image */
+    Skipped
+};
+
+/** @class DeviceOutcomes
+ *
+ *  @brief Outcome and attempts of every device of the last activation of a
+ *         version, published as com.Nvidia.Software.DeviceOutcomes:
+ *         Devices a{s(su)} - outcome and attempts by inventory path
+ *  Outcomes are kept when the activation fails, a resumed activation only
+ *  updates the devices which are not Updated or no longer run its image.
+ */
+class DeviceOutcomes
+{
+  public:
+    static constexpr auto interfaceName = "com.Nvidia.Software.DeviceOutcomes";
+
+    /**
+     * @brief Constructor
+     *
+     * @param bus
+     * @param objPath - version object
+     */
+    DeviceOutcomes(sdbusplus::bus::bus& bus, const std::string& objPath);
+
+    /**
+     * @brief Get the outcome of the device
+     *
+     * @param device - inventory path
+     * @return std::optional<DeviceOutcome> - std::nullopt if not known
+     */
+    std::optional<DeviceOutcome> get(const std::string& device) const;
+
+    /**
+     * @brief Set the outcome of the device, a change is signaled
+     *
+     * @param device - inventory path
+     * @param outcome
+     */
+    void set(const std::string& device, DeviceOutcome outcome);
+
+    /**
+     * @brief Get the devices with the outcome
+     *
+     * @param outcome
+     * @return std::vector<std::string> - inventory paths
+     */
+    std::vector<std::string> find(DeviceOutcome outcome) const;
+
+    /**
+     * @brief Counts an update attempt of the device, its outcome becomes
+     *        Updating
+     *
+     * @param device - inventory path
+     */
+    void addAttempt(const std::string& device);
+
+    /**
+     * @brief Get the update attempts of the device
+     *
+     * @param device - inventory path
+     * @return uint32_t
+     */
+    uint32_t getAttempts(const std::string& device) const;
+
+    /**
+     * @brief Drops the device, its outcome is not known anymore
+     *
+     * @param device - inventory path
+     */
+    void erase(const std::string& device);
+
+    /**
+     * @brief Drops the devices which are not Updated and resets the attempts,
+     *        for an activation resuming a failed one
+     */
+    void resume();
+
+    /**
+     * @brief Drops all devices
+     */
+    void clear();
+
+    /**
+     * @brief Checks if a device failed all its attempts
+     *
+     * @return true
+     * @return false
+     */
+    bool anyFailed() const;
+
+    /**
+     * @brief Get the name of an outcome
+     *
+     * @param outcome
+     * @return const char*
+     */
+    static const char* toString(DeviceOutcome outcome);
+
+  private:
+    struct Entry
+    {
+        DeviceOutcome outcome = DeviceOutcome::Queued;
+        uint32_t attempts = 0;
+    };
+
+    static int getDevices(sd_bus* bus, const char* path, const char* iface,
+                          const char* property, sd_bus_message* reply,
+                          void* context, sd_bus_error* error);
+
+    static const sdbusplus::vtable_t vtable[];
+
+    std::map<std::string, Entry> entries;
+
+    sdbusplus::server::interface::interface serverInterface;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,198 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class DeviceRegistry
+ *
+ *  @brief Devices of an item updater in configuration order, with hashed
+ *         lookups by inventory path, ID and bus/address. DeviceT has to
+ *         provide getInventoryPath().
+ */
+template <typename DeviceT>
+class DeviceRegistry
+{
+  public:
+    using iterator = typename std::vector<std::unique_ptr<DeviceT>>::iterator;
+    using const_iterator =
+        typename std::vector<std::unique_ptr<DeviceT>>::const_iterator;
+
+    /**
+     * @brief Adds a device, a device with the same inventory path as a
+     * registered one is dropped
+     *
+     * @param id - device ID from the configuration
+     * @param bus - I2C bus
+     * @param address - I2C address
+     * @param device
+     * @return true if the device was added
+     */
+    bool add(const std::string& id, uint32_t bus, uint32_t address,
+             std::unique_ptr<DeviceT> device)
+    {
+        auto index = devices.size();
+        if (!byPath.emplace(device->getInventoryPath(), index).second)
+        {
+            return false;
+        }
+        byId.emplace(id, index);
+        byAddress.emplace(addressKey(bus, address), index);
+        devices.emplace_back(std::move(device));
+        return true;
+    }
+
+    /**
+     * @brief Find the device of an inventory path
+     *
+     * @param inventoryPath
+     * @return DeviceT* - nullptr if not registered
+     */
+    DeviceT* findByPath(const std::string& inventoryPath) const
+    {
+        return find(byPath, inventoryPath);
+    }
+
+    /**
+     * @brief Find the device of a configuration ID
+     *
+     * @param id
+     * @return DeviceT* - nullptr if not registered
+     */
+    DeviceT* findById(const std::string& id) const
+    {
+        return find(byId, id);
+    }
+
+    /**
+     * @brief Find the device at an I2C bus and address
+     *
+     * @param bus
+     * @param address
+     * @return DeviceT* - nullptr if not registered
+     */
+    DeviceT* findByAddress(uint32_t bus, uint32_t address) const
+    {
+        return find(byAddress, addressKey(bus, address));
+    }
+
+    /**
+     * @brief Check if a device is registered for the inventory path
+     *
+     * @param inventoryPath
+     * @return true if registered
+     */
+    bool contains(const std::string& inventoryPath) const
+    {
+        return byPath.contains(inventoryPath);
+    }
+
+    /**
+     * @brief Get the inventory paths in configuration order
+     *
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> getInventoryPaths() const
+    {
+        std::vector<std::string> paths;
+        paths.reserve(devices.size());
+        for (const auto& device : devices)
+        {
+            paths.emplace_back(device->getInventoryPath());
+        }
+        return paths;
+    }
+
+    /**
+     * @brief Get the first configured device, the registry must not be empty
+     *
+     * @return DeviceT&
+     */
+    DeviceT& front() const
+    {
+        return *devices.front();
+    }
+
+    bool empty() const
+    {
+        return devices.empty();
+    }
+
+    size_t size() const
+    {
+        return devices.size();
+    }
+
+    iterator begin()
+    {
+        return devices.begin();
+    }
+
+    iterator end()
+    {
+        return devices.end();
+    }
+
+    const_iterator begin() const
+    {
+        return devices.begin();
+    }
+
+    const_iterator end() const
+    {
+        return devices.end();
+    }
+
+  private:
+    static uint64_t addressKey(uint32_t bus, uint32_t address)
+    {
+        return (static_cast<uint64_t>(bus) << 32) | address;
+    }
+
+    template <typename IndexT, typename KeyT>
+    DeviceT* find(const IndexT& index, const KeyT& key) const
+    {
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+            return nullptr;
+        }
+        return devices[it->second].get();
+    }
+
+    std::vector<std::unique_ptr<DeviceT>> devices;
+    std::unordered_map<std::string, size_t> byPath;
+    std::unordered_map<std::string, size_t> byId;
+    std::unordered_map<uint64_t, size_t> byAddress;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
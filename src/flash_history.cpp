@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flash_history.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <vector>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+using json = nlohmann::json;
+
+/** @brief added to the scaled percentile, covers the start of the unit */
+constexpr uint64_t timeoutMargin = 60;
+
+void FlashHistory::load()
+{
+    samples.clear();
+    std::ifstream in(file);
+    if (!in.is_open())
+    {
+        return;
+    }
+    auto data = json::parse(in, nullptr, false);
+    if (data.is_discarded() || !data.is_object() ||
+        data.value("schema", 0) != schemaVersion)
+    {
+        log<level::WARNING>("Ignoring flash history",
+                            entry("FILE=%s", file.c_str()));
+        return;
+    }
+    auto keys = data.value("durations", json::object());
+    if (!keys.is_object())
+    {
+        return;
+    }
+    for (auto it = keys.begin(); it != keys.end(); ++it)
+    {
+        const auto& durations = it.value();
+        if (!durations.is_array())
+        {
+            continue;
+        }
+        auto& kept = samples[it.key()];
+        for (const auto& duration : durations)
+        {
+            if (duration.is_number_unsigned())
+            {
+                kept.push_back(duration.get<uint64_t>());
+            }
+        }
+        while (kept.size() > maxSamples)
+        {
+            kept.pop_front();
+        }
+    }
+}
+
+void FlashHistory::save() const
+{
+    json data;
+    data["schema"] = schemaVersion;
+    data["durations"] = samples;
+
+    std::error_code ec;
+    std::filesystem::create_directories(file.parent_path(), ec);
+    auto tmp = file;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << data.dump();
+        if (!out.good())
+        {
+            log<level::ERR>("Unable to write flash history",
+                            entry("FILE=%s", tmp.c_str()));
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    // A reader sees either the old or the new file
+    std::filesystem::rename(tmp, file, ec);
+    if (ec)
+    {
+        log<level::ERR>("Unable to replace flash history",
+                        entry("FILE=%s", file.c_str()),
+                        entry("ERROR=%s", ec.message().c_str()));
+    }
+}
+
+std::string FlashHistory::makeKey(const std::string& model,
+                                  uintmax_t imageSize)
+{
+    constexpr uintmax_t mib = 1024 * 1024;
+    return model + ":" + std::to_string((imageSize + mib - 1) / mib);
+}
+
+void FlashHistory::add(const std::string& key, std::chrono::seconds duration)
+{
+    auto& kept = samples[key];
+    kept.push_back(std::max<int64_t>(duration.count(), 0));
+    if (kept.size() > maxSamples)
+    {
+        kept.pop_front();
+    }
+}
+
+std::optional<std::chrono::seconds>
+    FlashHistory::percentile(const std::string& key, unsigned percent) const
+{
+    auto it = samples.find(key);
+    if (it == samples.end() || it->second.empty())
+    {
+        return std::nullopt;
+    }
+    std::vector<uint64_t> sorted(it->second.begin(), it->second.end());
+    // nearest rank
+    auto rank = (std::min(percent, 100u) * sorted.size() + 99) / 100;
+    auto index = rank == 0 ? 0 : rank - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return std::chrono::seconds(sorted[index]);
+}
+
+uint32_t FlashHistory::getTimeout(const std::string& key,
+                                  uint32_t configured) const
+{
+    if (size(key) < minSamples)
+    {
+        return configured;
+    }
+    auto p95 = static_cast<uint64_t>(percentile(key, 95)->count());
+    auto timeout = p95 + p95 / 2 + timeoutMargin;
+    return static_cast<uint32_t>(
+        std::min<uint64_t>(timeout, configured));
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class FlashHistory
+ *
+ *  @brief Persists the durations of the last successful flashes of an item
+ *         updater, keyed by device model and image size. The update timeout
+ *         of a device is derived from the flashes of the same key instead of
+ *         the worst case configured for the device class.
+ */
+class FlashHistory
+{
+  public:
+    /** @brief Version of the file layout, files of other versions are
+     *  ignored */
+    static constexpr int schemaVersion = 2;
+
+    /** @brief durations kept per key, older ones are dropped */
+    static constexpr size_t maxSamples = 32;
+
+    /** @brief durations needed before the configured timeout is lowered */
+    static constexpr size_t minSamples = 5;
+
+    /** @brief Constructor
+     *
+     *  @param[in] file - history file, created on first save
+     */
+    explicit FlashHistory(const std::filesystem::path& file) : file(file)
+    {}
+
+    /**
+     * @brief Loads the history file, a missing, corrupt or foreign version
+     * file leaves the history empty
+     */
+    void load();
+
+    /**
+     * @brief Writes the history file atomically
+     */
+    void save() const;
+
+    /**
+     * @brief Get the key of a device model and image size. Sizes are
+     * rounded up to whole MiB so rebuilds of an image share their history
+     *
+     * @param model
+     * @param imageSize - in bytes
+     * @return std::string
+     */
+    static std::string makeKey(const std::string& model, uintmax_t imageSize);
+
+    /**
+     * @brief Adds the duration of a successful flash
+     *
+     * @param key
+     * @param duration
+     */
+    void add(const std::string& key, std::chrono::seconds duration);
+
+    /**
+     * @brief Get the duration not exceeded by the given share of the flashes
+     * of a key
+     *
+     * @param key
+     * @param percent - 0 to 100
+     * @return std::optional<std::chrono::seconds> - std::nullopt if there is
+     *         no history
+     */
+    std::optional<std::chrono::seconds> percentile(const std::string& key,
+                                                   unsigned percent) const;
+
+    /**
+     * @brief Get the update timeout in seconds, half again the 95th
+     * percentile of the key plus a margin. The configured timeout is
+     * returned while the history of the key is too short and is never
+     * exceeded.
+     *
+     * @param key
+     * @param configured - worst case timeout of the device class
+     * @return uint32_t
+     */
+    uint32_t getTimeout(const std::string& key, uint32_t configured) const;
+
+    /**
+     * @brief Get the number of durations kept for a key
+     *
+     * @param key
+     * @return size_t
+     */
+    size_t size(const std::string& key) const
+    {
+        auto it = samples.find(key);
+        return it == samples.end() ? 0 : it->second.size();
+    }
+
+  private:
+    std::filesystem::path file;
+
+    /** @brief durations in seconds by key, oldest first */
+    std::map<std::string, std::deque<uint64_t>> samples;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "fpga_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <fmt/format.h>
 
@@ -34,14 +35,8 @@ namespace updater
 {
 std::string FPGAItemUpdater::getVersion(const std::string& inventoryPath) const
 {
-    for (auto& inv : invs)
-    {
-        if (inv->getInventoryPath() == inventoryPath)
-        {
-            return inv->getVersion();
-        }
-    }
-    return "";
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->getVersion() : "";
 }
 
 std::string
@@ -56,6 +51,34 @@ std::string FPGAItemUpdater::getModel(const std::string& inventoryPath) const
     (void)inventoryPath;
     return "CECModel";
 }
+
+std::optional<uint32_t>
+    FPGAItemUpdater::getDeviceBus(const std::string& inventoryPath) const
+{
+    if (auto inv = invs.findByPath(inventoryPath))
+    {
+        return inv->getBus();
+    }
+    return std::nullopt;
+}
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<FPGAItemUpdater>(bus);
+}
+} // namespace
+
+constexpr UpdaterDescriptor fpgaUpdater = {
+    .name = "FPGA",
+    .busName = FPGA_BUSNAME_UPDATER,
+    .service = FPGA_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 #ifndef MOCK_UTILS
 #include <fpga_util.hpp> // part of nvidia-cec
@@ -64,6 +65,16 @@ class CECDevice : public fpga_ceccommonutils::Util
     {
         return inventoryPath;
     }
+
+    /**
+     * @brief Get the I2C bus of the device
+     *
+     * @return uint32_t
+     */
+    uint32_t getBus() const
+    {
+        return b;
+    }
 };
 /**
  * @brief concrete class for FPGA
@@ -72,7 +83,7 @@ class CECDevice : public fpga_ceccommonutils::Util
  */
 class FPGAItemUpdater : public BaseItemUpdater
 {
-    std::vector<std::unique_ptr<CECDevice>> invs;
+    DeviceRegistry<CECDevice> invs;
 
   public:
     /**
@@ -82,7 +93,8 @@ class FPGAItemUpdater : public BaseItemUpdater
      */
     FPGAItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(bus, FPGA_SUPPORTED_MODEL, FPGA_INVENTORY_IFACE, "FPGA",
-                        FPGA_BUSNAME_UPDATER, FPGA_UPDATE_SERVICE, false,
+                        std::string(fpgaUpdater.busName),
+                        std::string(fpgaUpdater.service), false,
                         FPGA_BUSNAME_INVENTORY)
     {
         nlohmann::json fruJson = fpga_ceccommonutils::loadJSONFile(
@@ -106,17 +118,13 @@ class FPGAItemUpdater : public BaseItemUpdater
                 uint8_t busId = std::stoi(busN);
                 uint8_t devAddr = std::stoi(address, nullptr, 16);
 
-                auto invMatch = std::find_if(
-                    invs.begin(), invs.end(), [&invpath](auto& inv) {
-                        return inv->getInventoryPath() == invpath;
-                    });
-                if (invMatch != invs.end())
+                if (invs.contains(invpath))
                 {
                     continue;
                 }
                 auto inv =
                     std::make_unique<CECDevice>(invpath, busId, devAddr, id);
-                invs.emplace_back(std::move(inv));
+                invs.add(id, busId, devAddr, std::move(inv));
             }
             catch (const std::exception& e)
             {
@@ -151,6 +159,15 @@ class FPGAItemUpdater : public BaseItemUpdater
      */
     std::string getModel(const std::string& inventoryPath) const override;
 
+    /**
+     * @brief Get the I2C bus of the device
+     *
+     * @param inventoryPath
+     * @return std::optional<uint32_t>
+     */
+    std::optional<uint32_t>
+        getDeviceBus(const std::string& inventoryPath) const override;
+
     /**
      * @brief Get the Service Args object
      *
@@ -164,7 +181,8 @@ class FPGAItemUpdater : public BaseItemUpdater
         getServiceArgs([[maybe_unused]] const std::string& inventoryPath,
                        const std::string& imagePath,
                        const std::string& version,
-                       const TargetFilter /* &targetFilter */) const override
+                       [[maybe_unused]] const TargetFilter& targetFilter)
+            const override
     {
 
         // The systemd unit shall be escaped
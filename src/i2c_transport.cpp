@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "i2c_transport.hpp"
+
+#include "i2c_utils.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+
+I2cTransport::~I2cTransport()
+{
+    if (-1 != fd)
+    {
+        close(fd);
+    }
+}
+
+bool I2cTransport::openBus()
+{
+    if (-1 != fd)
+    {
+        return true;
+    }
+    if (unavailable)
+    {
+        return false;
+    }
+    auto devicePath = "/dev/i2c-" + std::to_string(bus);
+    fd = open(devicePath.c_str(), O_RDWR | O_CLOEXEC);
+    if (-1 == fd)
+    {
+        log<level::WARNING>("Unable to open i2c bus, using shell fallback",
+                            entry("BUS=%s", devicePath.c_str()));
+        unavailable = true;
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::string> I2cTransport::readBlock(uint8_t command,
+                                                   size_t size)
+{
+    if (size == 0 || !openBus())
+    {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> commandData{command};
+    std::vector<uint8_t> readData(size);
+    if (!recovery_tool::i2c_utils::sendI2cCmdForRead(fd, address, commandData,
+                                                     readData, false))
+    {
+        return std::nullopt;
+    }
+
+    // The first byte is the byte count, anything else is not a block read
+    if (readData[0] == 0 || readData[0] >= size)
+    {
+        return std::nullopt;
+    }
+    auto begin = std::next(readData.begin());
+    auto end = std::next(begin, readData[0]);
+    std::string ret;
+    std::copy_if(begin, end, std::back_inserter(ret),
+                 [](unsigned char c) { return std::isprint(c); });
+    if (ret.empty())
+    {
+        return std::nullopt;
+    }
+    return ret;
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class I2cTransport
+ *
+ *  @brief Reads SMBus/PMBus block registers of a device directly through
+ *         the i2c-dev node, without spawning the i2c helper scripts.
+ */
+class I2cTransport
+{
+  public:
+    /** @brief Constructor
+     *
+     *  @param[in] bus - I2C bus number
+     *  @param[in] address - 7 bit slave address of the device
+     */
+    I2cTransport(uint32_t bus, uint16_t address) : bus(bus), address(address)
+    {}
+
+    I2cTransport(const I2cTransport&) = delete;
+    I2cTransport& operator=(const I2cTransport&) = delete;
+    I2cTransport(I2cTransport&&) = delete;
+    I2cTransport& operator=(I2cTransport&&) = delete;
+
+    /** @brief dtor - closes the i2c-dev node */
+    ~I2cTransport();
+
+    /**
+     * @brief Reads an SMBus block register and decodes it as a string. Only
+     *        the bytes counted by the first byte are used and non printable
+     *        characters are removed, as the shell command does.
+     *
+     * @param command - register to read
+     * @param size - number of bytes to read including the count byte
+     * @return std::optional<std::string> - std::nullopt if the read failed,
+     *         the count byte is out of range or no printable data was read
+     */
+    std::optional<std::string> readBlock(uint8_t command, size_t size);
+
+  private:
+    /**
+     * @brief Opens the i2c-dev node of the bus once
+     *
+     * @return true if the node is usable
+     */
+    bool openBus();
+
+    uint32_t bus;
+    uint16_t address;
+
+    /** @brief i2c-dev file descriptor */
+    int fd = -1;
+
+    /** @brief set once the node failed to open, no retry after that */
+    bool unavailable = false;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
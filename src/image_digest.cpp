@@ -0,0 +1,204 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_digest.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <string_view>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+
+/** @brief Size of the window mapped at once, a multiple of the page size */
+constexpr size_t digestWindowSize = 1024 * 1024;
+
+ImageDigester::ImageDigester(const std::filesystem::path& file,
+                             const std::string& algorithm) :
+    file(file), ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free)
+{
+    const EVP_MD* md = EVP_get_digestbyname(algorithm.c_str());
+    if (md == nullptr)
+    {
+        log<level::ERR>("Unknown digest algorithm",
+                        entry("ALGORITHM=%s", algorithm.c_str()));
+        finish(false);
+        return;
+    }
+    fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        log<level::ERR>("Unable to open image for digest",
+                        entry("FILE=%s", file.c_str()));
+        finish(false);
+        return;
+    }
+    struct stat st
+    {};
+    if (!ctx || fstat(fd, &st) != 0 ||
+        EVP_DigestInit_ex(ctx.get(), md, nullptr) != 1)
+    {
+        finish(false);
+        return;
+    }
+    size = st.st_size;
+}
+
+ImageDigester::~ImageDigester()
+{
+    if (-1 != fd)
+    {
+        close(fd);
+    }
+}
+
+bool ImageDigester::update(size_t maxBytes)
+{
+    if (done)
+    {
+        return true;
+    }
+    size_t hashed = 0;
+    while (offset < size && hashed < maxBytes)
+    {
+        size_t length = std::min<size_t>(digestWindowSize, size - offset);
+        void* window =
+            mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, offset);
+        if (window == MAP_FAILED)
+        {
+            finish(false);
+            return true;
+        }
+        madvise(window, length, MADV_SEQUENTIAL);
+        bool ok = EVP_DigestUpdate(ctx.get(), window, length) == 1;
+        munmap(window, length);
+        if (!ok)
+        {
+            finish(false);
+            return true;
+        }
+        offset += length;
+        hashed += length;
+    }
+    if (offset < size)
+    {
+        return false;
+    }
+    finish(true);
+    return true;
+}
+
+void ImageDigester::finish(bool ok)
+{
+    done = true;
+    if (-1 != fd)
+    {
+        close(fd);
+        fd = -1;
+    }
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int mdLength = 0;
+    if (!ok || EVP_DigestFinal_ex(ctx.get(), md, &mdLength) != 1)
+    {
+        log<level::ERR>("Unable to compute image digest",
+                        entry("FILE=%s", file.c_str()));
+        return;
+    }
+
+    static constexpr char hex[] = "0123456789abcdef";
+    digest.reserve(mdLength * 2);
+    for (unsigned int i = 0; i < mdLength; i++)
+    {
+        digest.push_back(hex[md[i] >> 4]);
+        digest.push_back(hex[md[i] & 0x0f]);
+    }
+}
+
+std::string computeImageDigest(const std::filesystem::path& file,
+                               const std::string& algorithm)
+{
+    ImageDigester digester(file, algorithm);
+    while (!digester.update(digestWindowSize))
+    {}
+    return digester.result();
+}
+
+const sdbusplus::vtable_t ImageDigestInterface::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("Digest", "s",
+                                ImageDigestInterface::getProperty,
+                                sdbusplus::vtable::property_::const_),
+    sdbusplus::vtable::property("Algorithm", "s",
+                                ImageDigestInterface::getProperty,
+                                sdbusplus::vtable::property_::const_),
+    sdbusplus::vtable::end()};
+
+ImageDigestInterface::ImageDigestInterface(sdbusplus::bus::bus& bus,
+                                           const std::string& objPath,
+                                           const std::string& digest,
+                                           const std::string& algorithm) :
+    digest(digest),
+    algorithm(algorithm),
+    serverInterface(bus, objPath.c_str(), interfaceName, vtable, this)
+{
+    serverInterface.emit_added();
+}
+
+int ImageDigestInterface::getProperty(sd_bus* /* bus */,
+                                      const char* /* path */,
+                                      const char* /* iface */,
+                                      const char* property,
+                                      sd_bus_message* reply, void* context,
+                                      sd_bus_error* /* error */)
+{
+    auto digestInterface = static_cast<ImageDigestInterface*>(context);
+    try
+    {
+        sdbusplus::message::message m(reply);
+        if (std::string_view(property) == "Digest")
+        {
+            m.append(digestInterface->digest);
+        }
+        else
+        {
+            m.append(digestInterface->algorithm);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Unable to reply image digest",
+                        entry("ERROR=%s", e.what()));
+        return -EINVAL;
+    }
+    return 1;
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,147 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/evp.h>
+#include <sys/types.h>
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class ImageDigester
+ *
+ *  @brief Computes the digest of an image file in steps, so that a large
+ *         image can be hashed between other events of the loop. The file
+ *         is opened once and mapped in 1 MiB windows, memory use does not
+ *         grow with the image size.
+ */
+class ImageDigester
+{
+  public:
+    /**
+     * @brief Constructor, opens the file
+     *
+     * @param file - image to hash
+     * @param algorithm - OpenSSL digest name, e.g. SHA256 or SHA512
+     */
+    ImageDigester(const std::filesystem::path& file,
+                  const std::string& algorithm);
+
+    ImageDigester(const ImageDigester&) = delete;
+    ImageDigester& operator=(const ImageDigester&) = delete;
+
+    /** @brief dtor - closes the file */
+    ~ImageDigester();
+
+    /**
+     * @brief Hashes the next part of the file
+     *
+     * @param maxBytes - bytes to hash at most in this step
+     * @return true once the digest is complete or failed
+     */
+    bool update(size_t maxBytes);
+
+    /**
+     * @brief Get the digest
+     *
+     * @return const std::string& - lower case hex digest, empty on failure
+     *         or while incomplete
+     */
+    const std::string& result() const
+    {
+        return digest;
+    }
+
+  private:
+    /** @brief Finalizes the digest, on failure it stays empty */
+    void finish(bool ok);
+
+    std::filesystem::path file;
+    int fd = -1;
+    off_t size = 0;
+    off_t offset = 0;
+    bool done = false;
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx;
+    std::string digest;
+};
+
+/**
+ * @brief Computes the digest of an image file in one streaming pass
+ *
+ * @param file - image to hash
+ * @param algorithm - OpenSSL digest name, e.g. SHA256 or SHA512
+ * @return std::string - lower case hex digest, empty on failure
+ */
+std::string computeImageDigest(const std::filesystem::path& file,
+                               const std::string& algorithm);
+
+/** @class ImageDigestInterface
+ *
+ *  @brief com.Nvidia.Software.ImageDigest D-Bus interface, published on the
+ *         version objects of uploaded images:
+ *         Digest s    - lower case hex digest of the image
+ *         Algorithm s - digest algorithm, e.g. SHA256
+ */
+class ImageDigestInterface
+{
+  public:
+    static constexpr auto interfaceName = "com.Nvidia.Software.ImageDigest";
+
+    /**
+     * @brief Constructor
+     *
+     * @param bus
+     * @param objPath
+     * @param digest
+     * @param algorithm
+     */
+    ImageDigestInterface(sdbusplus::bus::bus& bus, const std::string& objPath,
+                         const std::string& digest,
+                         const std::string& algorithm);
+
+  private:
+    static int getProperty(sd_bus* bus, const char* path, const char* iface,
+                           const char* property, sd_bus_message* reply,
+                           void* context, sd_bus_error* error);
+
+    static const sdbusplus::vtable_t vtable[];
+
+    std::string digest;
+
+    std::string algorithm;
+
+    sdbusplus::server::interface::interface serverInterface;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
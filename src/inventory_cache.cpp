@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "inventory_cache.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+using json = nlohmann::json;
+
+void InventoryCache::load()
+{
+    entries.clear();
+    std::ifstream in(file);
+    if (!in.is_open())
+    {
+        return;
+    }
+    auto data = json::parse(in, nullptr, false);
+    if (data.is_discarded() || !data.is_object() ||
+        data.value("schema", 0) != schemaVersion)
+    {
+        log<level::WARNING>("Ignoring inventory cache",
+                            entry("FILE=%s", file.c_str()));
+        return;
+    }
+    auto items = data.value("entries", json::object());
+    for (const auto& item : items.items())
+    {
+        const auto& value = item.value();
+        Entry e;
+        e.version = value.value("version", std::string{});
+        e.model = value.value("model", std::string{});
+        e.manufacturer = value.value("manufacturer", std::string{});
+        e.uuid = value.value("uuid", std::string{});
+        e.flashedDigest = value.value("flashedDigest", std::string{});
+        e.flashedVersion = value.value("flashedVersion", std::string{});
+        e.stamp = value.value("stamp", uint64_t{0});
+        if (!e.version.empty())
+        {
+            entries.emplace(item.key(), std::move(e));
+        }
+    }
+}
+
+void InventoryCache::save() const
+{
+    json data;
+    data["schema"] = schemaVersion;
+    auto items = json::object();
+    for (const auto& [path, e] : entries)
+    {
+        items[path] = {{"version", e.version},
+                       {"model", e.model},
+                       {"manufacturer", e.manufacturer},
+                       {"uuid", e.uuid},
+                       {"flashedDigest", e.flashedDigest},
+                       {"flashedVersion", e.flashedVersion},
+                       {"stamp", e.stamp}};
+    }
+    data["entries"] = items;
+
+    std::error_code ec;
+    std::filesystem::create_directories(file.parent_path(), ec);
+    auto tmp = file;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << data.dump();
+        if (!out.good())
+        {
+            log<level::ERR>("Unable to write inventory cache",
+                            entry("FILE=%s", tmp.c_str()));
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    // A reader sees either the old or the new file
+    std::filesystem::rename(tmp, file, ec);
+    if (ec)
+    {
+        log<level::ERR>("Unable to replace inventory cache",
+                        entry("FILE=%s", file.c_str()),
+                        entry("ERROR=%s", ec.message().c_str()));
+    }
+}
+
+std::optional<InventoryCache::Entry>
+    InventoryCache::find(const std::string& inventoryPath) const
+{
+    auto it = entries.find(inventoryPath);
+    if (it == entries.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool InventoryCache::update(const std::string& inventoryPath, Entry entry)
+{
+    auto it = entries.find(inventoryPath);
+    if (it != entries.end() && it->second.version == entry.version &&
+        it->second.model == entry.model &&
+        it->second.manufacturer == entry.manufacturer &&
+        it->second.uuid == entry.uuid &&
+        it->second.flashedDigest == entry.flashedDigest &&
+        it->second.flashedVersion == entry.flashedVersion)
+    {
+        return false;
+    }
+    entry.stamp = std::chrono::duration_cast<std::chrono::seconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    entries[inventoryPath] = std::move(entry);
+    return true;
+}
+
+bool InventoryCache::setFlashedDigest(const std::string& inventoryPath,
+                                      const std::string& digest)
+{
+    auto it = entries.find(inventoryPath);
+    if (it == entries.end() || (it->second.flashedDigest == digest &&
+                                it->second.flashedVersion.empty()))
+    {
+        return false;
+    }
+    it->second.flashedDigest = digest;
+    it->second.flashedVersion.clear();
+    return true;
+}
+
+bool InventoryCache::retain(const std::vector<std::string>& inventoryPaths)
+{
+    auto size = entries.size();
+    std::erase_if(entries, [&inventoryPaths](const auto& item) {
+        return std::find(inventoryPaths.begin(), inventoryPaths.end(),
+                         item.first) == inventoryPaths.end();
+    });
+    return size != entries.size();
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class InventoryCache
+ *
+ *  @brief Persists the last known firmware details of the devices of an
+ *         item updater, keyed by inventory path. It lets a restarted
+ *         code-manager publish the software objects before the devices are
+ *         read again.
+ */
+class InventoryCache
+{
+  public:
+    /** @brief Version of the file layout, files of other versions are
+     *  ignored */
+    static constexpr int schemaVersion = 1;
+
+    struct Entry
+    {
+        std::string version;
+        std::string model;
+        std::string manufacturer;
+        std::string uuid;
+        /** @brief digest of the image code-manager flashed last */
+        std::string flashedDigest;
+        /** @brief version read after that flash, empty until read */
+        std::string flashedVersion;
+        /** @brief seconds since epoch when the entry was last written */
+        uint64_t stamp = 0;
+    };
+
+    /** @brief Constructor
+     *
+     *  @param[in] file - cache file, created on first save
+     */
+    explicit InventoryCache(const std::filesystem::path& file) : file(file)
+    {}
+
+    /**
+     * @brief Loads the cache file, a missing, corrupt or foreign version
+     * file leaves the cache empty
+     */
+    void load();
+
+    /**
+     * @brief Writes the cache file atomically
+     */
+    void save() const;
+
+    /**
+     * @brief Get the entries
+     *
+     * @return const std::map<std::string, Entry>&
+     */
+    const std::map<std::string, Entry>& getEntries() const
+    {
+        return entries;
+    }
+
+    /**
+     * @brief Find the entry of the device
+     *
+     * @param inventoryPath
+     * @return std::optional<Entry>
+     */
+    std::optional<Entry> find(const std::string& inventoryPath) const;
+
+    /**
+     * @brief Stores the details of the device, the stamp is set when
+     * something changed
+     *
+     * @param inventoryPath
+     * @param entry
+     * @return true if the entry was added or changed
+     */
+    bool update(const std::string& inventoryPath, Entry entry);
+
+    /**
+     * @brief Records the digest of the image flashed to a cached device, the
+     * version it runs is recorded by the next update
+     *
+     * @param inventoryPath
+     * @param digest - empty to forget it
+     * @return true if the entry changed
+     */
+    bool setFlashedDigest(const std::string& inventoryPath,
+                          const std::string& digest);
+
+    /**
+     * @brief Drops the entries of devices which are not present anymore
+     *
+     * @param inventoryPaths - devices present
+     * @return true if an entry was dropped
+     */
+    bool retain(const std::vector<std::string>& inventoryPaths);
+
+  private:
+    std::filesystem::path file;
+
+    std::map<std::string, Entry> entries;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -17,6 +17,7 @@
 
 #include "config.h"
 #include "jamplayer.hpp"
+#include "updater_registry.hpp"
 #include <boost/format.hpp>
 
 namespace nvidia
@@ -43,6 +44,24 @@ std::string JamPlayer::getModel([
 {
     return "";
 }
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<JamPlayer>(bus);
+}
+} // namespace
+
+constexpr UpdaterDescriptor jamplayerUpdater = {
+    .name = "JAMPLAYER",
+    .busName = JAMPLAYER_BUSNAME_UPDATER,
+    .service = JAMPLAYER_SERVICE,
+    .timeout = JAMPLAYER_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
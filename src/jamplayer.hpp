@@ -20,6 +20,7 @@
 
 #include "base_item_updater.hpp"
 #include "fstream"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -33,7 +34,8 @@ class JamPlayer : public BaseItemUpdater
   public:
     JamPlayer(sdbusplus::bus::bus& bus) :
 		BaseItemUpdater(bus, JAMPLAYER_SUPPORTED_MODEL, JAMPLAYER_INVENTORY_IFACE, "JAMPLAYER",
-						JAMPLAYER_BUSNAME_UPDATER, JAMPLAYER_SERVICE, false, JAMPLAYER_BUSNAME_INVENTORY)
+						std::string(jamplayerUpdater.busName),
+						std::string(jamplayerUpdater.service), false, JAMPLAYER_BUSNAME_INVENTORY)
     {
     }
 
@@ -111,7 +113,7 @@ class JamPlayer : public BaseItemUpdater
      */
     uint32_t getTimeout() override
     {
-        return JAMPLAYER_TIMEOUT;
+        return jamplayerUpdater.timeout;
     }
 
     /**
@@ -18,57 +18,28 @@
 #include "config.h"
 
 #include "base_controller.hpp"
-#ifdef PSU_SUPPORT
-#include "psu_updater.hpp"
-#endif
-#ifdef FPGA_SUPPORT
-#include "fpga_updater.hpp"
-#endif
-#ifdef CPLD_SUPPORT
-#include "cpld_updater.hpp"
-#endif
-#ifdef RT_SUPPORT
-#include "retimer_updater.hpp"
-#endif
-#ifdef PEX_SUPPORT
-#include "pex_updater.hpp"
-#endif
-#ifdef ORIN_FLASH_SUPPORT
-#include "orin_updater.hpp"
-#endif
-#ifdef SMCU_FLASH_SUPPORT
-#include "smcu_updater.hpp"
-#endif
-#ifdef DEBUG_TOKEN_SUPPORT
-#include "debug_token_install.hpp"
-#include "debug_token_erase.hpp"
-#endif
-#if MTD_SUPPORT
-#include "mtd_updater.hpp"
-#endif
-#if SWITCHTEC_FUSE_SUPPORT
-#include "switchtec_fuse.hpp"
-#endif
-#if JAMPLAYER_SUPPORT
-#include "jamplayer.hpp"
-#endif
-
+#include "updater_registry.hpp"
 #include "watch.hpp"
 
 #include <getopt.h>
 
+#include <boost/algorithm/string.hpp>
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 
 #include <cstdlib>
 #include <exception>
+#include <vector>
 
 using namespace phosphor::logging;
 
 static struct option set_opts[] = {
     {"updater", required_argument, NULL, 'u'},
     {"fallback", no_argument, NULL, 'f'},
+    {"lazy", no_argument, NULL, 'l'},
+    {"list", no_argument, NULL, 'L'},
+    {0, 0, 0, 0},
 };
 static void print_wrong_arg_exit(void)
 {
@@ -76,15 +47,31 @@ static void print_wrong_arg_exit(void)
     exit(EXIT_FAILURE);
 }
 
+/**
+ * @brief Prints the updaters built into this binary
+ */
+static void printUpdaters(void)
+{
+    using namespace nvidia::software::updater;
+    for (const auto* descriptor : UpdaterRegistry::getDescriptors())
+    {
+        printf("%.*s %.*s %.*s %u\n", static_cast<int>(descriptor->name.size()),
+               descriptor->name.data(),
+               static_cast<int>(descriptor->busName.size()),
+               descriptor->busName.data(),
+               static_cast<int>(descriptor->service.size()),
+               descriptor->service.data(), descriptor->timeout);
+    }
+}
+
 int main(int argc, char** argv)
 {
+    using namespace nvidia::software::updater;
     std::string updater = "";
     auto ret = 0;
-    bool useFallback = false;
-    (void)useFallback; // if RT_SUPPORT is disabled this isn't used currently
-    std::string targetName = "";
-    std::string modelName = "";
-    while ((ret = getopt_long(argc, argv, "u:i:m:f", set_opts, NULL)) != -1)
+    bool lazy = false;
+    UpdaterOptions options;
+    while ((ret = getopt_long(argc, argv, "u:i:m:flL", set_opts, NULL)) != -1)
     {
         switch (ret)
         {
@@ -92,17 +79,22 @@ int main(int argc, char** argv)
                 updater = optarg;
                 break;
             case 'i':
-                targetName = optarg;
+                options.targetName = optarg;
                 break;
             case 'm':
-                modelName = optarg;
+                options.modelName = optarg;
                 break;
+            case 'l':
+                lazy = true;
+                break;
+            case 'L':
+                printUpdaters();
+                exit(EXIT_SUCCESS);
             default:
                 print_wrong_arg_exit();
         }
     }
-    
-    using namespace nvidia::software::updater;
+
     auto bus = sdbusplus::bus::new_default();
 
     sd_event* loop = nullptr;
@@ -110,98 +102,47 @@ int main(int argc, char** argv)
 
     sdbusplus::server::manager::manager objManager(bus, SOFTWARE_OBJPATH);
 
-    std::unique_ptr<BaseController> abstractController;
-    std::unique_ptr<BaseItemUpdater> itemUpdater;
-#if PSU_SUPPORT
-    if (updater == "PSU")
-    {
-        itemUpdater = std::make_unique<PSUItemUpdater>(bus);
-    }
-#endif
-#if FPGA_SUPPORT
-    if (updater == "FPGA")
-    {
-        itemUpdater = std::make_unique<FPGAItemUpdater>(bus);
-    }
-#endif
-#if CPLD_SUPPORT
-    if (updater == "CPLD")
-    {
-        itemUpdater = std::make_unique<CPLDItemUpdater>(bus);
-    }
-#endif
-#if RT_SUPPORT
-    if (updater == "Retimer")
-    {
-        /* default option is to do update together, if fallback is specified
-           then we use the single updater */
-        itemUpdater = std::make_unique<ReTimerItemUpdater>(bus, !useFallback);
-    }
-#endif
-#if PEX_SUPPORT
-    if (updater == "PEX")
-    {
-        itemUpdater = std::make_unique<PEXItemUpdater>(bus);
-    }
-#endif
-#if ORIN_FLASH_SUPPORT
-    if (updater == "ORIN")
-    {
-        itemUpdater = std::make_unique<ORINItemUpdater>(bus);
-    }
-#endif
-#if SMCU_FLASH_SUPPORT
-    if (updater == "SMCU")
+    // A comma separated list hosts several updaters in this process
+    std::vector<std::unique_ptr<BaseItemUpdater>> itemUpdaters;
+    std::vector<std::string> updaterNames;
+    boost::split(updaterNames, updater, boost::is_any_of(","));
+    for (const auto& name : updaterNames)
     {
-        itemUpdater = std::make_unique<SMCUItemUpdater>(bus);
-    }
-#endif
-#if DEBUG_TOKEN_SUPPORT
-    try
-    {
-        if (updater == "DebugTokenInstall")
+        auto descriptor = UpdaterRegistry::find(name);
+        if (descriptor == nullptr)
         {
-            itemUpdater = std::make_unique<DebugTokenInstallItemUpdater>(bus);
+            printf("UnSupported Updater \"%s\"\n", name.c_str());
+            exit(EXIT_FAILURE);
         }
-        else if (updater == "DebugTokenErase")
+        std::unique_ptr<BaseItemUpdater> itemUpdater;
+        try
         {
-            itemUpdater = std::make_unique<DebugTokenEraseItemUpdater>(bus);
+            itemUpdater = descriptor->factory(bus, options);
         }
-    }
-    catch (const std::exception& e)
-    {
-        log<level::ERR>("Debug token object exception",
-                        entry("TOKEN_EXCEPTION=%s", e.what()));
-        exit(EXIT_FAILURE);
-    }
-#endif
-#if MTD_SUPPORT
-    if (updater == "MTD")
-    {
-        itemUpdater = std::make_unique<MTDItemUpdater>(bus, targetName, modelName);
-    }
-#endif
-#if SWITCHTEC_FUSE_SUPPORT
-    if (updater == "SWITCHTEC")
-    {
-        itemUpdater = std::make_unique<SwitchtecFuse>(bus);
-    }
-#endif
-#if JAMPLAYER_SUPPORT
-    if (updater == "JAMPLAYER")
-    {
-        itemUpdater = std::make_unique<JamPlayer>(bus);
-    }
-#endif
-
-    if (itemUpdater == nullptr)
-    {
-        printf("UnSupported Updater \"%s\"\n", updater.c_str());
-        exit(EXIT_FAILURE);
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("Unable to create the updater",
+                            entry("UPDATER=%s", name.c_str()),
+                            entry("ERROR=%s", e.what()));
+            exit(EXIT_FAILURE);
+        }
+        for (const auto& hosted : itemUpdaters)
+        {
+            if (hosted->getBusName() == itemUpdater->getBusName())
+            {
+                printf("Duplicate Updater \"%s\"\n", name.c_str());
+                exit(EXIT_FAILURE);
+            }
+        }
+        itemUpdaters.emplace_back(std::move(itemUpdater));
     }
     try
     {
-        bus.request_name(itemUpdater->getBusName().c_str());
+        // Each updater keeps its own well-known name on the shared bus
+        for (const auto& itemUpdater : itemUpdaters)
+        {
+            bus.request_name(itemUpdater->getBusName().c_str());
+        }
     }
     catch (const sdbusplus::exception::SdBusError& e)
     {
@@ -209,9 +150,17 @@ int main(int argc, char** argv)
             entry("ERROR=%s", e.what()));
         return -1;
     }
-    abstractController = std::make_unique<BaseController>(itemUpdater);
+    auto abstractController = std::make_unique<BaseController>(itemUpdaters);
 
-    if (abstractController->processExistingImages())
+    if (lazy)
+    {
+        // Watch uploads first, existing images follow from the event loop
+        if (abstractController->scheduleExistingImages(loop))
+        {
+            return -1;
+        }
+    }
+    else if (abstractController->processExistingImages())
     {
         return -1;
     }
@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "mtd_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
@@ -49,6 +50,25 @@ std::string MTDItemUpdater::getModel([
 {
     return "";
 }
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions& options)
+{
+    return std::make_unique<MTDItemUpdater>(bus, options.targetName,
+                                            options.modelName);
+}
+} // namespace
+
+constexpr UpdaterDescriptor mtdUpdater = {
+    .name = "MTD",
+    .busName = MTD_BUSNAME_UPDATER_BASE,
+    .service = MTD_UPDATE_SERVICE,
+    .timeout = MTD_UPDATE_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
@@ -20,6 +20,7 @@
 
 #include "base_item_updater.hpp"
 #include "fstream"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -35,8 +36,9 @@ class MTDItemUpdater : public BaseItemUpdater
   public:
     MTDItemUpdater(sdbusplus::bus::bus& bus, std::string mtdN, std::string modelName) :
 		BaseItemUpdater(bus, modelName, MTD_INVENTORY_IFACE, "MTD_FW_" + mtdN,
-						MTD_BUSNAME_UPDATER_BASE + mtdN,
-                        MTD_UPDATE_SERVICE, false, MTD_BUSNAME_INVENTORY_BASE + mtdN),
+						std::string(mtdUpdater.busName) + mtdN,
+                        std::string(mtdUpdater.service), false,
+                        MTD_BUSNAME_INVENTORY_BASE + mtdN),
 		mtdName(mtdN)
 
     {
@@ -114,7 +116,7 @@ class MTDItemUpdater : public BaseItemUpdater
      */
     uint32_t getTimeout() override
     {
-        return MTD_UPDATE_TIMEOUT;
+        return mtdUpdater.timeout;
     }
 
     /**
@@ -17,6 +17,7 @@
 
 
 #include "orin_updater.hpp"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -40,6 +41,23 @@ std::string ORINItemUpdater::getModel([[maybe_unused]] const std::string& invent
     return "";
 }
 
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<ORINItemUpdater>(bus);
+}
+} // namespace
+
+constexpr UpdaterDescriptor orinUpdater = {
+    .name = "ORIN",
+    .busName = ORIN_BUSNAME_UPDATER,
+    .service = ORIN_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
@@ -19,6 +19,7 @@
 #pragma once
 #include "config.h"
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -42,7 +43,8 @@ class ORINItemUpdater : public BaseItemUpdater
      */
     ORINItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(bus, ORIN_SUPPORTED_MODEL, ORIN_INVENTORY_IFACE, "ORIN",
-                        ORIN_BUSNAME_UPDATER, ORIN_UPDATE_SERVICE, false,
+                        std::string(orinUpdater.busName),
+                        std::string(orinUpdater.service), false,
                         ORIN_BUSNAME_INVENTORY)
     {}
     /**
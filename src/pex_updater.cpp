@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "pex_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <boost/algorithm/string.hpp>
 
@@ -48,6 +49,24 @@ std::string PEXItemUpdater::getModel(const std::string& inventoryPath) const
     (void)inventoryPath;
     return "AMD EPYC 7742 64-Core Processor";
 }
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<PEXItemUpdater>(bus);
+}
+} // namespace
+
+constexpr UpdaterDescriptor pexUpdater = {
+    .name = "PEX",
+    .busName = PEX_BUSNAME_UPDATER,
+    .service = PEX_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -43,7 +44,8 @@ class PEXItemUpdater : public BaseItemUpdater
      */
     PEXItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(bus, PEX_SUPPORTED_MODEL, PEX_INVENTORY_IFACE, "PEX",
-                        PEX_BUSNAME_UPDATER, PEX_UPDATE_SERVICE, false,
+                        std::string(pexUpdater.busName),
+                        std::string(pexUpdater.service), false,
                         PEX_BUSNAME_INVENTORY)
     {}
     // TODO add VDT methods here
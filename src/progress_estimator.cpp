@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "progress_estimator.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+
+/** @brief weight of the latest sample in the smoothed rate */
+constexpr double rateSmoothing = 0.2;
+
+/** @brief samples closer than this are merged, to not divide by zero */
+constexpr auto minSampleInterval = std::chrono::milliseconds(500);
+
+void ProgressEstimator::start(size_t devices, Clock::time_point now)
+{
+    this->devices = devices;
+    completed = 0;
+    running.clear();
+    rate.reset();
+    lastFraction = 0;
+    lastSample = now;
+}
+
+void ProgressEstimator::update(const std::string& device, double fraction,
+                               Clock::time_point now)
+{
+    auto& value = running[device];
+    value = std::max(value, std::clamp(fraction, 0.0, 1.0));
+    sample(now);
+}
+
+void ProgressEstimator::done(const std::string& device, Clock::time_point now)
+{
+    running.erase(device);
+    completed = std::min(completed + 1, devices);
+    sample(now);
+}
+
+void ProgressEstimator::failed(const std::string& device,
+                               Clock::time_point now)
+{
+    running.erase(device);
+    sample(now);
+}
+
+double ProgressEstimator::getFraction() const
+{
+    if (devices == 0)
+    {
+        return 1;
+    }
+    double sum = completed;
+    for (const auto& [device, fraction] : running)
+    {
+        sum += fraction;
+    }
+    return std::min(sum / devices, 1.0);
+}
+
+std::optional<std::chrono::seconds>
+    ProgressEstimator::getRemaining(Clock::time_point now) const
+{
+    if (!rate || *rate <= 0)
+    {
+        return std::nullopt;
+    }
+    // Progress made since the last sample is already accounted for
+    double elapsed = std::chrono::duration<double>(now - lastSample).count();
+    double left = (1 - getFraction()) / *rate - elapsed;
+    return std::chrono::seconds(std::lround(std::max(left, 0.0)));
+}
+
+void ProgressEstimator::sample(Clock::time_point now)
+{
+    if (now - lastSample < minSampleInterval)
+    {
+        return;
+    }
+    auto fraction = getFraction();
+    double elapsed = std::chrono::duration<double>(now - lastSample).count();
+    double current = std::max(fraction - lastFraction, 0.0) / elapsed;
+    rate = rate ? rateSmoothing * current + (1 - rateSmoothing) * *rate
+                : current;
+    lastFraction = fraction;
+    lastSample = now;
+}
+
+const sdbusplus::vtable_t ActivationEstimate::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("RemainingTime", "x",
+                                ActivationEstimate::getRemainingTime,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::end()};
+
+ActivationEstimate::ActivationEstimate(sdbusplus::bus::bus& bus,
+                                       const std::string& objPath) :
+    serverInterface(bus, objPath.c_str(), interfaceName, vtable, this)
+{
+    serverInterface.emit_added();
+}
+
+void ActivationEstimate::remainingTime(int64_t value)
+{
+    if (remaining != value)
+    {
+        remaining = value;
+        serverInterface.property_changed("RemainingTime");
+    }
+}
+
+int ActivationEstimate::getRemainingTime(sd_bus* /* bus */,
+                                         const char* /* path */,
+                                         const char* /* iface */,
+                                         const char* /* property */,
+                                         sd_bus_message* reply, void* context,
+                                         sd_bus_error* /* error */)
+{
+    auto estimate = static_cast<ActivationEstimate*>(context);
+    try
+    {
+        sdbusplus::message::message m(reply);
+        m.append(estimate->remaining);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Unable to reply remaining time",
+                        entry("ERROR=%s", e.what()));
+        return -EINVAL;
+    }
+    return 1;
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class ProgressEstimator
+ *
+ *  @brief Combines the progress the update units report for their devices
+ *         into the progress of the activation and estimates the time left
+ *         from the smoothed progress rate
+ */
+class ProgressEstimator
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Starts a new estimate
+     *
+     * @param devices - devices updated by the activation
+     * @param now
+     */
+    void start(size_t devices, Clock::time_point now);
+
+    /**
+     * @brief Sets the share of the device already flashed, progress never
+     *        goes back
+     *
+     * @param device - inventory path
+     * @param fraction - 0 to 1
+     * @param now
+     */
+    void update(const std::string& device, double fraction,
+                Clock::time_point now);
+
+    /**
+     * @brief Marks the device as flashed
+     *
+     * @param device - inventory path
+     * @param now
+     */
+    void done(const std::string& device, Clock::time_point now);
+
+    /**
+     * @brief Drops the progress of a failed attempt, a retry reports its
+     *        progress from the start again
+     *
+     * @param device - inventory path
+     * @param now
+     */
+    void failed(const std::string& device, Clock::time_point now);
+
+    /**
+     * @brief Get the share of the activation done, 0 to 1
+     *
+     * @return double
+     */
+    double getFraction() const;
+
+    /**
+     * @brief Get the estimated time left
+     *
+     * @param now
+     * @return std::optional<std::chrono::seconds> - std::nullopt until a
+     *         rate is known
+     */
+    std::optional<std::chrono::seconds>
+        getRemaining(Clock::time_point now) const;
+
+  private:
+    /**
+     * @brief Folds the progress made since the last sample into the rate
+     *
+     * @param now
+     */
+    void sample(Clock::time_point now);
+
+    size_t devices = 0;
+
+    /** @brief devices flashed completely */
+    size_t completed = 0;
+
+    /** @brief share flashed of the devices being updated */
+    std::map<std::string, double> running;
+
+    /** @brief progress per second, exponentially smoothed */
+    std::optional<double> rate;
+
+    double lastFraction = 0;
+
+    Clock::time_point lastSample;
+};
+
+/** @class ActivationEstimate
+ *
+ *  @brief com.Nvidia.Software.ActivationEstimate D-Bus interface, published
+ *         next to ActivationProgress while a version is activating:
+ *         RemainingTime x - estimated seconds until the activation is done,
+ *                           -1 while unknown
+ */
+class ActivationEstimate
+{
+  public:
+    static constexpr auto interfaceName =
+        "com.Nvidia.Software.ActivationEstimate";
+
+    /**
+     * @brief Constructor
+     *
+     * @param bus
+     * @param objPath
+     */
+    ActivationEstimate(sdbusplus::bus::bus& bus, const std::string& objPath);
+
+    /**
+     * @brief Get the estimated seconds left
+     *
+     * @return int64_t
+     */
+    int64_t remainingTime() const
+    {
+        return remaining;
+    }
+
+    /**
+     * @brief Set the estimated seconds left, a change is signaled
+     *
+     * @param value - -1 if unknown
+     */
+    void remainingTime(int64_t value);
+
+  private:
+    static int getRemainingTime(sd_bus* bus, const char* path,
+                                const char* iface, const char* property,
+                                sd_bus_message* reply, void* context,
+                                sd_bus_error* error);
+
+    static const sdbusplus::vtable_t vtable[];
+
+    int64_t remaining = -1;
+
+    sdbusplus::server::interface::interface serverInterface;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
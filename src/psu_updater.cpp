@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "psu_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <boost/algorithm/string.hpp>
 
@@ -33,43 +34,96 @@ namespace updater
 
 std::string PSUItemUpdater::getVersion(const std::string& inventoryPath) const
 {
-    std::string ret = "";
-    for (auto& inv : invs)
-    {
-        if (inv->getInventoryPath() == inventoryPath)
-        {
-            ret = inv->getVersion();
-        }
-    }
-    return ret;
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->getVersion() : "";
 }
 
 std::string
     PSUItemUpdater::getManufacturer(const std::string& inventoryPath) const
 {
-    std::string ret = "";
-    for (auto& inv : invs)
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->getManufacturer() : "";
+}
+
+std::string PSUItemUpdater::getModel(const std::string& inventoryPath) const
+{
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->getModel() : "";
+}
+
+DeviceSnapshot PowerSupplyDevice::readAsset() const
+{
+    // The utility reads one field per run, a single shell runs it for all
+    // of them and ends every output with a record separator
+    auto cmd = fmt::format(
+        "for c in {0} {1} {2}; do {3} {4} $c; printf '\\036'; done",
+        commandList[VERSION_INDEX], commandList[MODEL_INDEX],
+        commandList[MANUFACTURE_INDEX], commandUtilityName, Id);
+    std::string output;
+    try
     {
-        if (inv->getInventoryPath() == inventoryPath)
+        for (const auto& line : psucommonutils::executeCmd(cmd))
         {
-            ret = inv->getManufacturer();
+            output += line;
         }
     }
-    return ret;
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Unable to read PSU asset",
+                        entry("ID=%s", Id.c_str()),
+                        entry("ERROR=%s", e.what()));
+        return {};
+    }
+    std::vector<std::string> fields;
+    boost::split(fields, output, boost::is_any_of("\036"));
+    for (auto& field : fields)
+    {
+        psucommonutils::stripUnicode(field);
+    }
+    DeviceSnapshot snapshot;
+    if (fields.size() > 3)
+    {
+        snapshot.version = fields[0];
+        snapshot.model = fields[1];
+        snapshot.manufacturer = fields[2];
+    }
+    return snapshot;
 }
 
-std::string PSUItemUpdater::getModel(const std::string& inventoryPath) const
+DeviceSnapshot
+    PSUItemUpdater::readDeviceSnapshot(const std::string& inventoryPath)
 {
-    std::string ret = "";
-    for (auto& inv : invs)
+    auto inv = invs.findByPath(inventoryPath);
+    return inv ? inv->readAsset() : DeviceSnapshot{};
+}
+
+std::optional<uint32_t>
+    PSUItemUpdater::getDeviceBus(const std::string& inventoryPath) const
+{
+    if (auto inv = invs.findByPath(inventoryPath))
     {
-        if (inv->getInventoryPath() == inventoryPath)
-        {
-            ret = inv->getModel();
-        }
+        return inv->getBus();
     }
-    return ret;
+    return std::nullopt;
 }
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<PSUItemUpdater>(bus);
+}
+} // namespace
+
+constexpr UpdaterDescriptor psuUpdater = {
+    .name = "PSU",
+    .busName = PSU_BUSNAME_UPDATER,
+    .service = PSU_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <sstream>
 
@@ -69,6 +70,10 @@ class PowerSupplyDevice : public psucommonutils::PSShellIntf
         std::string ret = convert.str();
         return ret;
     }
+    uint32_t getBus() const
+    {
+        return I2cBus;
+    }
     const std::string getBusNum()
     {
         std::ostringstream convert;
@@ -83,6 +88,14 @@ class PowerSupplyDevice : public psucommonutils::PSShellIntf
         std::string ret = convert.str();
         return ret;
     }
+
+    /**
+     * @brief Reads version, model and manufacturer with a single shell
+     *        invocation of the PSU command utility
+     *
+     * @return DeviceSnapshot - fields are empty if the read failed
+     */
+    DeviceSnapshot readAsset() const;
 };
 /**
  * @brief PSU item updater
@@ -91,7 +104,7 @@ class PowerSupplyDevice : public psucommonutils::PSShellIntf
  */
 class PSUItemUpdater : public BaseItemUpdater
 {
-    std::vector<std::unique_ptr<PowerSupplyDevice>> invs;
+    DeviceRegistry<PowerSupplyDevice> invs;
     std::map<std::string, std::unique_ptr<SoftwareVersion>> softwareVersionIntf;
 
   public:
@@ -102,7 +115,8 @@ class PSUItemUpdater : public BaseItemUpdater
      */
     PSUItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(bus, PSU_SUPPORTED_MODEL, PSU_INVENTORY_IFACE, "PSU",
-                        PSU_BUSNAME_UPDATER, PSU_UPDATE_SERVICE, false,
+                        std::string(psuUpdater.busName),
+                        std::string(psuUpdater.service), false,
                         PSU_BUSNAME_INVENTORY)
     {
         nlohmann::json fruJson = psucommonutils::loadJSONFile(
@@ -125,17 +139,13 @@ class PSUItemUpdater : public BaseItemUpdater
                 uint32_t busnum = fru.at("I2cBus");
                 uint32_t slaveaddress = fru.at("I2cSlaveAddress");
 
-                auto invMatch = std::find_if(
-                    invs.begin(), invs.end(), [&invpath](auto& inv) {
-                        return inv->getInventoryPath() == invpath;
-                    });
-                if (invMatch != invs.end())
+                if (invs.contains(invpath))
                 {
                     continue;
                 }
                 auto inv = std::make_unique<PowerSupplyDevice>(
                     invpath, "powersupply" + id, id, busnum, slaveaddress);
-                invs.emplace_back(std::move(inv));
+                invs.add(id, busnum, slaveaddress, std::move(inv));
             }
             catch (const std::exception& e)
             {
@@ -168,6 +178,24 @@ class PSUItemUpdater : public BaseItemUpdater
      * @return std::string
      */
     std::string getModel(const std::string& inventoryPath) const override;
+
+    /**
+     * @brief Reads version, model and manufacturer of the device in one pass
+     *
+     * @param inventoryPath
+     * @return DeviceSnapshot
+     */
+    DeviceSnapshot readDeviceSnapshot(const std::string& inventoryPath) override;
+
+    /**
+     * @brief Get the I2C bus of the device
+     *
+     * @param inventoryPath
+     * @return std::optional<uint32_t>
+     */
+    std::optional<uint32_t>
+        getDeviceBus(const std::string& inventoryPath) const override;
+
     /**
      * @brief Get the Service Args object
      *
@@ -185,19 +213,15 @@ class PSUItemUpdater : public BaseItemUpdater
 
         // The systemd unit shall be escaped
         std::string args = "";
-        for (auto& inv : invs)
+        if (auto inv = invs.findByPath(inventoryPath))
         {
-            if (inv->getInventoryPath() == inventoryPath)
-            {
-                args += "\\x20";
-                args += inv->getBusNum();
-                args += "\\x20";
-                args += inv->getSlaveAddress();
-                args += "\\x20";
-                args += imagePath;
-                args += "\\x20";
-                break;
-            }
+            args += "\\x20";
+            args += inv->getBusNum();
+            args += "\\x20";
+            args += inv->getSlaveAddress();
+            args += "\\x20";
+            args += imagePath;
+            args += "\\x20";
         }
         std::replace(args.begin(), args.end(), '/', '-');
         return args;
@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include "retimer_updater.hpp"
+#include "updater_registry.hpp"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
@@ -35,22 +36,18 @@ std::string
     ReTimerItemUpdater::getVersion(const std::string& inventoryPath) const
 {
     std::string ret = "";
-    for (auto& inv : invs)
+    if (auto inv = invs.findByPath(inventoryPath))
     {
-        if (inv->getInventoryPath() == inventoryPath)
+        std::string swPath =
+            (boost::format(RT_SW_VERSION_PATH) % inv->getId()).str();
+        try
         {
-            std::string swPath =
-                (boost::format(RT_SW_VERSION_PATH) % inv->getId()).str();
-            try
-            {
-                ret = getProperty<std::string>(RT_BUSNAME_INVENTORY,
-                                               swPath.c_str(), VERSION_IFACE,
-                                               VERSION);
-            }
-            catch (const std::exception& e)
-            {
-                // ignore the exception for retimer
-            }
+            ret = getProperty<std::string>(RT_BUSNAME_INVENTORY, swPath.c_str(),
+                                           VERSION_IFACE, VERSION);
+        }
+        catch (const std::exception& e)
+        {
+            // ignore the exception for retimer
         }
     }
     return ret;
@@ -76,7 +73,7 @@ std::string ReTimerItemUpdater::getSKU() const
         return {};
     }
 
-    std::string swPath = std::string(RT_INVENTORY_PATH) + invs.at(0)->getId();
+    std::string swPath = std::string(RT_INVENTORY_PATH) + invs.front().getId();
     std::string ret{};
     try
     {
@@ -90,6 +87,76 @@ std::string ReTimerItemUpdater::getSKU() const
     }
     return ret;
 }
+
+void ReTimerItemUpdater::onSWInventoryChangedMsg(
+    sdbusplus::message::message& msg)
+{
+    std::optional<Properties> properties;
+    try
+    {
+        if (std::string(msg.get_member()) == "InterfacesAdded")
+        {
+            sdbusplus::message::object_path objPath;
+            std::map<std::string, Properties> interfaces;
+            msg.read(objPath, interfaces);
+            auto it = interfaces.find(ASSET_IFACE);
+            if (it == interfaces.end())
+            {
+                return;
+            }
+            properties = it->second;
+        }
+        else
+        {
+            std::string iface;
+            Properties changed;
+            msg.read(iface, changed);
+            properties = std::move(changed);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Error reading inventory signal",
+                        entry("ERROR=%s", e.what()));
+        updateSKU();
+        return;
+    }
+    auto sku = findProperty<std::string>(*properties, "SKU");
+    if (sku)
+    {
+        deviceSKUInventoryObj->sku(*sku);
+    }
+}
+
+std::optional<uint32_t>
+    ReTimerItemUpdater::getDeviceBus(const std::string& inventoryPath) const
+{
+    if (auto inv = invs.findByPath(inventoryPath))
+    {
+        return inv->getBus();
+    }
+    return std::nullopt;
+}
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions& options)
+{
+    /* default option is to do update together, if fallback is
+       specified then we use the single updater */
+    return std::make_unique<ReTimerItemUpdater>(bus, !options.useFallback);
+}
+} // namespace
+
+constexpr UpdaterDescriptor retimerUpdater = {
+    .name = "Retimer",
+    .busName = RT_BUSNAME_UPDATER,
+    .service = RT_UPDATE_SERVICE,
+    .timeout = RT_UPDATE_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
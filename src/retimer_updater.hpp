@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 #include <bitset>
 #include <filesystem>
 #include "fmt/core.h"
@@ -81,7 +82,7 @@ class RTDevice : public rtcommonutils::Util
  */
 class ReTimerItemUpdater : public BaseItemUpdater
 {
-    std::vector<std::unique_ptr<RTDevice>> invs;
+    DeviceRegistry<RTDevice> invs;
     std::unique_ptr<DeviceSKU> deviceSKUInventoryObj;
     const std::string objPath = std::string(SOFTWARE_OBJPATH) + "/" + std::string(RT_NAME);
 
@@ -94,8 +95,9 @@ class ReTimerItemUpdater : public BaseItemUpdater
      */
     ReTimerItemUpdater(sdbusplus::bus::bus& bus, bool together) :
         BaseItemUpdater(bus, RT_SUPPORTED_MODEL, RT_INVENTORY_IFACE,
-                        RT_NAME, RT_BUSNAME_UPDATER,
-                        RT_UPDATE_SERVICE, together, RT_BUSNAME_INVENTORY)
+                        RT_NAME, std::string(retimerUpdater.busName),
+                        std::string(retimerUpdater.service), together,
+                        RT_BUSNAME_INVENTORY)
     {
 
         nlohmann::json fruJson = rtcommonutils::loadJSONFile(
@@ -118,17 +120,13 @@ class ReTimerItemUpdater : public BaseItemUpdater
                 int busId = std::stoi(busN);
                 int devAddr = std::stoi(address, nullptr, 16);
 
-                auto invMatch = std::find_if(
-                    invs.begin(), invs.end(), [&invpath](auto& inv) {
-                        return inv->getInventoryPath() == invpath;
-                    });
-                if (invMatch != invs.end())
+                if (invs.contains(invpath))
                 {
                     continue;
                 }
                 auto inv =
                     std::make_unique<RTDevice>(invpath, busId, devAddr, id);
-                invs.emplace_back(std::move(inv));
+                invs.add(id, busId, devAddr, std::move(inv));
             }
             catch (const std::exception& e)
             {
@@ -173,6 +171,15 @@ class ReTimerItemUpdater : public BaseItemUpdater
     std::string getModel([
         [maybe_unused]] const std::string& inventoryPath) const override;
 
+    /**
+     * @brief Get the I2C bus of the device
+     *
+     * @param inventoryPath
+     * @return std::optional<uint32_t>
+     */
+    std::optional<uint32_t>
+        getDeviceBus(const std::string& inventoryPath) const override;
+
     /**
      * @brief Get retimer the devices to update object based on target filters
      * 
@@ -225,7 +232,7 @@ class ReTimerItemUpdater : public BaseItemUpdater
         {
             std::string devicesBits = getDevicesToUpdate(targetFilter);
             args += "\\x20";
-            args += std::to_string(invs[0]->getBus()); // pull first device bus
+            args += std::to_string(invs.front().getBus()); // pull first device bus
             args += "\\x20";
             args += devicesBits; // devices to update
             args += "\\x20";
@@ -237,18 +244,14 @@ class ReTimerItemUpdater : public BaseItemUpdater
         }
         else
         {
-            for (auto& inv : invs)
+            if (auto inv = invs.findByPath(inventoryPath))
             {
-                if (inv->getInventoryPath() == inventoryPath)
-                {
-                    args += "\\x20";
-                    args += std::to_string(inv->getBus());
-                    args += "\\x20";
-                    args += std::to_string(inv->getAddress());
-                    args += "\\x20";
-                    args += imagePath;
-                    break;
-                }
+                args += "\\x20";
+                args += std::to_string(inv->getBus());
+                args += "\\x20";
+                args += std::to_string(inv->getAddress());
+                args += "\\x20";
+                args += imagePath;
             }
         }
         std::replace(args.begin(), args.end(), '/', '-');
@@ -269,14 +272,7 @@ class ReTimerItemUpdater : public BaseItemUpdater
 
     bool pathIsValidDevice(std::string& p)
     {
-        for (auto& inv : invs)
-        {
-            if (inv->getInventoryPath() == p)
-            {
-                return true;
-            }
-        }
-        return false;
+        return invs.contains(p);
     }
 
     /**
@@ -288,12 +284,7 @@ class ReTimerItemUpdater : public BaseItemUpdater
      */
     std::vector<std::string> getItemUpdaterInventoryPaths() override
     {
-        std::vector<std::string> ret;
-        for (auto& inv : invs)
-        {
-            ret.emplace_back(inv->getInventoryPath());
-        }
-        return ret;
+        return invs.getInventoryPaths();
     }
 
     /**
@@ -331,7 +322,7 @@ class ReTimerItemUpdater : public BaseItemUpdater
      */
     uint32_t getTimeout() override
     {
-        return RT_UPDATE_TIMEOUT;
+        return retimerUpdater.timeout;
     }
 
     /**
@@ -346,15 +337,14 @@ class ReTimerItemUpdater : public BaseItemUpdater
     }
 
     /**
-     * @brief callback method to update sku on the RT.Updater object
+     * @brief callback method to update sku on the RT.Updater object, the SKU
+     * is taken from the signal payload and only read over D-Bus if the
+     * payload can not be parsed
      *
-     * @param msg - unused
+     * @param msg - PropertiesChanged or InterfacesAdded signal
      * @return void
      */
-    void onSWInventoryChangedMsg([[maybe_unused]] sdbusplus::message::message& msg)
-    {
-        updateSKU();
-    }
+    void onSWInventoryChangedMsg(sdbusplus::message::message& msg);
 
     /**
      * @brief sets the sku property on the inventory interface of the RT.Updater object
@@ -380,8 +370,12 @@ class ReTimerItemUpdater : public BaseItemUpdater
 
         deviceSKUInventoryObj = std::make_unique<DeviceSKU>(bus, objPath);
         updateSKU();
+        if (invs.empty())
+        {
+            return;
+        }
 
-        std::string inventoryObjPath = std::string(RT_INVENTORY_PATH) + invs.at(0)->getId();
+        std::string inventoryObjPath = std::string(RT_INVENTORY_PATH) + invs.front().getId();
         startWatchingInventory(inventoryObjPath);
     }
 
@@ -395,15 +389,15 @@ class ReTimerItemUpdater : public BaseItemUpdater
     void startWatchingInventory(const std::string& inventoryObjPath)
     {
         // Subscribe to the Inventory Object's PropertiesChanged signal
-        deviceMatches.emplace_back(
-            bus, MatchRules::propertiesChanged(inventoryObjPath.c_str(), ASSET_IFACE),
+        watchDeviceProperties(
+            inventoryObjPath, ASSET_IFACE,
             std::bind(&ReTimerItemUpdater::onSWInventoryChangedMsg, this,
                       std::placeholders::_1)); // For present
         
         // Subscribe to the Inventory Object's InterfacesAdded signal
         // for when the object is created
-        deviceMatches.emplace_back(
-            bus, MatchRules::interfacesAdded(inventoryObjPath.c_str()),
+        addDeviceMatch(
+            MatchRules::interfacesAdded(inventoryObjPath.c_str()),
             std::bind(&ReTimerItemUpdater::onSWInventoryChangedMsg, this,
                       std::placeholders::_1)); // For present
     }
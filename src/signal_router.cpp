@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "config.h"
+
+#include "signal_router.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <vector>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+namespace MatchRules = sdbusplus::bus::match::rules;
+
+void SignalRouter::Subscription::reset()
+{
+    if (id == 0)
+    {
+        return;
+    }
+    if (auto r = router.lock())
+    {
+        r->unsubscribe(id);
+    }
+    id = 0;
+}
+
+SignalRouter::SignalRouter(sdbusplus::bus::bus& bus) :
+    bus(bus),
+    jobRemovedMatch(std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        MatchRules::type::signal() + MatchRules::member("JobRemoved") +
+            MatchRules::path("/org/freedesktop/systemd1") +
+            MatchRules::interface("org.freedesktop.systemd1.Manager"),
+        std::bind(&SignalRouter::onJobRemoved, this, std::placeholders::_1)))
+{}
+
+std::shared_ptr<SignalRouter> SignalRouter::instance(sdbusplus::bus::bus& bus)
+{
+    static std::map<sd_bus*, std::weak_ptr<SignalRouter>> routers;
+    auto& router = routers[bus.get()];
+    auto ret = router.lock();
+    if (!ret)
+    {
+        ret = std::make_shared<SignalRouter>(bus);
+        router = ret;
+    }
+    return ret;
+}
+
+std::string SignalRouter::getNamespace(const std::string& path)
+{
+    for (const std::string root : {INVENTORY_PATH_BASE, SOFTWARE_OBJPATH})
+    {
+        if (path.starts_with(root + "/"))
+        {
+            return root;
+        }
+    }
+    return path;
+}
+
+SignalRouter::Subscription
+    SignalRouter::propertiesChanged(const std::string& path,
+                                    const std::string& interface,
+                                    Handler handler)
+{
+    auto rule = MatchRules::type::signal() +
+                MatchRules::member("PropertiesChanged") +
+                MatchRules::interface("org.freedesktop.DBus.Properties") +
+                MatchRules::path_namespace(getNamespace(path)) +
+                MatchRules::argN(0, interface);
+    auto& route = routes[rule];
+    if (!route.match)
+    {
+        route.match = std::make_unique<sdbusplus::bus::match_t>(
+            bus, rule, [this, &route](sdbusplus::message::message& msg) {
+                dispatch(route, msg);
+            });
+    }
+    auto id = nextId++;
+    route.handlers[path].emplace(id, std::move(handler));
+    subscriptions.emplace(id, std::make_pair(&route, path));
+    return Subscription(weak_from_this(), id);
+}
+
+SignalRouter::Subscription SignalRouter::jobRemoved(const std::string& job,
+                                                    JobHandler handler)
+{
+    auto id = nextId++;
+    auto previous = jobs.find(job);
+    if (previous != jobs.end())
+    {
+        // Job paths are not reused while the job exists
+        jobSubscriptions.erase(previous->second.first);
+    }
+    jobs[job] = std::make_pair(id, std::move(handler));
+    jobSubscriptions.emplace(id, job);
+    return Subscription(weak_from_this(), id);
+}
+
+void SignalRouter::unsubscribe(uint64_t id)
+{
+    if (auto it = subscriptions.find(id); it != subscriptions.end())
+    {
+        auto& [route, path] = it->second;
+        auto handlers = route->handlers.find(path);
+        if (handlers != route->handlers.end())
+        {
+            handlers->second.erase(id);
+            if (handlers->second.empty())
+            {
+                route->handlers.erase(handlers);
+            }
+        }
+        subscriptions.erase(it);
+    }
+    else if (auto job = jobSubscriptions.find(id);
+             job != jobSubscriptions.end())
+    {
+        jobs.erase(job->second);
+        jobSubscriptions.erase(job);
+    }
+}
+
+void SignalRouter::dispatch(Route& route, sdbusplus::message::message& msg)
+{
+    auto it = route.handlers.find(msg.get_path());
+    if (it == route.handlers.end())
+    {
+        return;
+    }
+    // A handler may drop subscriptions, each one is looked up again
+    std::vector<uint64_t> ids;
+    for (const auto& [id, handler] : it->second)
+    {
+        ids.push_back(id);
+    }
+    for (auto id : ids)
+    {
+        auto subscription = subscriptions.find(id);
+        if (subscription == subscriptions.end())
+        {
+            continue;
+        }
+        auto handler = route.handlers[subscription->second.second].at(id);
+        // Every handler reads the signal from the start
+        sd_bus_message_rewind(msg.get(), true);
+        try
+        {
+            handler(msg);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("Error handling PropertiesChanged",
+                            entry("PATH=%s", msg.get_path()),
+                            entry("ERROR=%s", e.what()));
+        }
+    }
+}
+
+void SignalRouter::onJobRemoved(sdbusplus::message::message& msg)
+{
+    uint32_t id{};
+    sdbusplus::message::object_path job;
+    std::string unit;
+    std::string result;
+    try
+    {
+        msg.read(id, job, unit, result);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Error reading JobRemoved",
+                        entry("ERROR=%s", e.what()));
+        return;
+    }
+    auto it = jobs.find(job.str);
+    if (it == jobs.end())
+    {
+        return;
+    }
+    // A job is removed once, the subscription ends with it
+    auto handler = std::move(it->second.second);
+    jobSubscriptions.erase(it->second.first);
+    jobs.erase(it);
+    handler(job.str, result);
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,212 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/**
+ * @brief Routes the signals of many objects through few match rules, shared
+ * by all users of a bus. PropertiesChanged of an interface is subscribed once
+ * per path namespace with an arg0 match, JobRemoved of systemd is subscribed
+ * once when the router is created. The signals are handed to the subscribers
+ * of the object or job by a hash lookup.
+ */
+class SignalRouter : public std::enable_shared_from_this<SignalRouter>
+{
+  public:
+    using Handler = std::function<void(sdbusplus::message::message&)>;
+
+    /**
+     * @brief Called with the job path and the result of a removed job
+     */
+    using JobHandler =
+        std::function<void(const std::string&, const std::string&)>;
+
+    /**
+     * @brief Subscription of a handler, the handler is not called anymore
+     * once the subscription is destroyed or reset
+     */
+    class Subscription
+    {
+      public:
+        Subscription() = default;
+
+        Subscription(std::weak_ptr<SignalRouter> router, uint64_t id) :
+            router(std::move(router)), id(id)
+        {}
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        Subscription(Subscription&& other) noexcept :
+            router(std::move(other.router)), id(other.id)
+        {
+            other.id = 0;
+        }
+
+        Subscription& operator=(Subscription&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                router = std::move(other.router);
+                id = other.id;
+                other.id = 0;
+            }
+            return *this;
+        }
+
+        ~Subscription()
+        {
+            reset();
+        }
+
+        /**
+         * @brief Unsubscribes the handler
+         */
+        void reset();
+
+      private:
+        std::weak_ptr<SignalRouter> router;
+
+        uint64_t id = 0;
+    };
+
+    SignalRouter(const SignalRouter&) = delete;
+    SignalRouter& operator=(const SignalRouter&) = delete;
+
+    /**
+     * @brief Construct a new Signal Router object and subscribe to
+     * JobRemoved, so that no job started later is missed
+     *
+     * @param bus
+     */
+    explicit SignalRouter(sdbusplus::bus::bus& bus);
+
+    /**
+     * @brief Get the router shared by all users of the bus
+     *
+     * @param bus
+     * @return std::shared_ptr<SignalRouter>
+     */
+    static std::shared_ptr<SignalRouter> instance(sdbusplus::bus::bus& bus);
+
+    /**
+     * @brief Subscribe to PropertiesChanged of an interface of an object
+     *
+     * @param path - object path
+     * @param interface
+     * @param handler - gets the unread signal
+     * @return Subscription
+     */
+    [[nodiscard]] Subscription propertiesChanged(const std::string& path,
+                                                 const std::string& interface,
+                                                 Handler handler);
+
+    /**
+     * @brief Subscribe to the removal of a systemd job, the handler is
+     * called once
+     *
+     * @param job - job object path
+     * @param handler
+     * @return Subscription
+     */
+    [[nodiscard]] Subscription jobRemoved(const std::string& job,
+                                          JobHandler handler);
+
+    /**
+     * @brief Drops a subscription, unknown ids are ignored
+     *
+     * @param id
+     */
+    void unsubscribe(uint64_t id);
+
+  private:
+    /**
+     * @brief One match rule and the handlers of the objects it covers
+     */
+    struct Route
+    {
+        std::unique_ptr<sdbusplus::bus::match_t> match;
+
+        /** @brief handlers by object path and subscription id */
+        std::unordered_map<std::string, std::map<uint64_t, Handler>> handlers;
+    };
+
+    /**
+     * @brief Get the namespace the PropertiesChanged match of the path
+     * covers, the roots of inventory and software objects or the path itself
+     *
+     * @param path
+     * @return std::string
+     */
+    static std::string getNamespace(const std::string& path);
+
+    /**
+     * @brief Calls the handlers subscribed to the path of the signal
+     *
+     * @param route
+     * @param msg
+     */
+    void dispatch(Route& route, sdbusplus::message::message& msg);
+
+    /**
+     * @brief JobRemoved signal handler
+     *
+     * @param msg
+     */
+    void onJobRemoved(sdbusplus::message::message& msg);
+
+    sdbusplus::bus::bus& bus;
+
+    uint64_t nextId = 1;
+
+    /** @brief routes by match rule, kept once created */
+    std::map<std::string, Route> routes;
+
+    /** @brief route and object path of the PropertiesChanged subscriptions */
+    std::unordered_map<uint64_t, std::pair<Route*, std::string>> subscriptions;
+
+    std::unique_ptr<sdbusplus::bus::match_t> jobRemovedMatch;
+
+    /** @brief subscription id and handler by job path */
+    std::unordered_map<std::string, std::pair<uint64_t, JobHandler>> jobs;
+
+    /** @brief job path of the JobRemoved subscriptions */
+    std::unordered_map<uint64_t, std::string> jobSubscriptions;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
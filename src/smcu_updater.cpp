@@ -17,6 +17,7 @@
 
 
 #include "smcu_updater.hpp"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -40,6 +41,23 @@ std::string SMCUItemUpdater::getModel([[maybe_unused]] const std::string& invent
     return "";
 }
 
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<SMCUItemUpdater>(bus);
+}
+} // namespace
+
+constexpr UpdaterDescriptor smcuUpdater = {
+    .name = "SMCU",
+    .busName = SMCU_BUSNAME_UPDATER,
+    .service = SMCU_UPDATE_SERVICE,
+    .timeout = NON_PLDM_DEFAULT_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
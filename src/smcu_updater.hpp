@@ -19,6 +19,7 @@
 #pragma once
 #include "config.h"
 #include "base_item_updater.hpp"
+#include "updater_registry.hpp"
 
 namespace nvidia
 {
@@ -42,7 +43,8 @@ class SMCUItemUpdater : public BaseItemUpdater
      */
     SMCUItemUpdater(sdbusplus::bus::bus& bus) :
         BaseItemUpdater(bus, SMCU_SUPPORTED_MODEL, SMCU_INVENTORY_IFACE, "SMCU",
-                        SMCU_BUSNAME_UPDATER, SMCU_UPDATE_SERVICE, false,
+                        std::string(smcuUpdater.busName),
+                        std::string(smcuUpdater.service), false,
                         SMCU_BUSNAME_INVENTORY)
     {}
     /**
@@ -0,0 +1,184 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "config.h"
+
+#include "status_channel.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+using namespace phosphor::logging;
+using namespace std::string_literals;
+
+/** @brief a line longer than this is dropped */
+constexpr size_t maxLineLength = 4096;
+
+StatusChannel::StatusChannel(const std::string& unit,
+                             LineCallback lineCallback) :
+    path(getPath(unit)),
+    lineCallback(std::move(lineCallback))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    // A FIFO left by an earlier run of the unit
+    std::filesystem::remove(path, ec);
+    if (0 > mkfifo(path.c_str(), 0600))
+    {
+        auto error = errno;
+        throw std::runtime_error("mkfifo failed, errno="s +
+                                 std::strerror(error));
+    }
+    // Holding a writer ourselves the FIFO never reports end of file, the
+    // tool may open and close it for every report
+    fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (-1 == fd)
+    {
+        auto error = errno;
+        std::filesystem::remove(path, ec);
+        throw std::runtime_error("open failed, errno="s +
+                                 std::strerror(error));
+    }
+    sd_event* loop = nullptr;
+    auto rc = sd_event_default(&loop);
+    if (0 <= rc)
+    {
+        rc = sd_event_add_io(loop, &source, fd, EPOLLIN, callback, this);
+        sd_event_unref(loop);
+    }
+    if (0 > rc)
+    {
+        close(fd);
+        std::filesystem::remove(path, ec);
+        throw std::runtime_error("failed to add to event loop, rc="s +
+                                 std::strerror(-rc));
+    }
+}
+
+StatusChannel::~StatusChannel()
+{
+    if (source)
+    {
+        sd_event_source_unref(source);
+    }
+    if (-1 != fd)
+    {
+        close(fd);
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+std::filesystem::path StatusChannel::getPath(const std::string& unit)
+{
+    return std::filesystem::path(FLASH_STATUS_DIR) / unit;
+}
+
+std::optional<double> StatusChannel::parseProgress(const std::string& line)
+{
+    std::istringstream in(line);
+    std::string key;
+    uint64_t done = 0;
+    if (!(in >> key >> done) || key != "PROGRESS")
+    {
+        return std::nullopt;
+    }
+    uint64_t total = 100;
+    if (!(in >> total))
+    {
+        total = 100;
+    }
+    if (total == 0)
+    {
+        return std::nullopt;
+    }
+    return std::min(static_cast<double>(done) / total, 1.0);
+}
+
+int StatusChannel::callback(sd_event_source* /* s */, int fd,
+                            uint32_t revents, void* userdata)
+{
+    if (!(revents & EPOLLIN))
+    {
+        return 0;
+    }
+    auto channel = static_cast<StatusChannel*>(userdata);
+
+    char buffer[512];
+    while (true)
+    {
+        auto bytes = read(fd, buffer, sizeof(buffer));
+        if (0 > bytes)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break; // EAGAIN, drained
+        }
+        if (0 == bytes)
+        {
+            break;
+        }
+        channel->partial.append(buffer, bytes);
+    }
+
+    size_t start = 0;
+    for (auto end = channel->partial.find('\n'); end != std::string::npos;
+         end = channel->partial.find('\n', start))
+    {
+        auto line = channel->partial.substr(start, end - start);
+        start = end + 1;
+        try
+        {
+            channel->lineCallback(line);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>("Error handling status line",
+                            entry("ERROR=%s", e.what()));
+        }
+    }
+    channel->partial.erase(0, start);
+    if (channel->partial.size() > maxLineLength)
+    {
+        log<level::WARNING>("Dropping overlong status line",
+                            entry("FIFO=%s", channel->path.c_str()));
+        channel->partial.clear();
+    }
+    return 0;
+}
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <systemd/sd-event.h>
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+/** @class StatusChannel
+ *
+ *  @brief FIFO an update unit reports its state through while it runs
+ *
+ *  The FIFO is created under FLASH_STATUS_DIR and named after the unit, the
+ *  unit files pass its path to the flash tool in STATUS_FIFO. A tool
+ *  writes one line per report, each line counts as a heartbeat. Tools which
+ *  never write are covered by the update timeout only. Progress is
+ *  reported as
+ *      PROGRESS <done> <total> - e.g. bytes written and image size
+ *      PROGRESS <percent>
+ */
+class StatusChannel
+{
+  public:
+    using LineCallback = std::function<void(const std::string&)>;
+
+    /** @brief ctor - create the FIFO and hook it with the default sd-event
+     *
+     *  @param[in] unit - name of the update unit
+     *  @param[in] lineCallback - called for every line read, must not
+     *                            destroy the channel
+     */
+    StatusChannel(const std::string& unit, LineCallback lineCallback);
+
+    StatusChannel(const StatusChannel&) = delete;
+    StatusChannel& operator=(const StatusChannel&) = delete;
+    StatusChannel(StatusChannel&&) = delete;
+    StatusChannel& operator=(StatusChannel&&) = delete;
+
+    /** @brief dtor - remove the event source and the FIFO
+     */
+    ~StatusChannel();
+
+    /** @brief Get the FIFO path of an update unit, the unit files expand
+     *         it as FLASH_STATUS_DIR/%n
+     *
+     *  @param[in] unit - name of the update unit
+     *  @returns std::filesystem::path
+     */
+    static std::filesystem::path getPath(const std::string& unit);
+
+    /** @brief Parse a progress report
+     *
+     *  @param[in] line - line read from the FIFO
+     *  @returns share done from 0 to 1, std::nullopt if the line is no
+     *           progress report
+     */
+    static std::optional<double> parseProgress(const std::string& line);
+
+  private:
+    /** @brief sd-event callback, reads the complete lines
+     *
+     *  @param[in] s - event source
+     *  @param[in] fd - FIFO fd
+     *  @param[in] revents - events that matched for fd
+     *  @param[in] userdata - pointer to StatusChannel object
+     *  @returns 0
+     */
+    static int callback(sd_event_source* s, int fd, uint32_t revents,
+                        void* userdata);
+
+    std::filesystem::path path;
+
+    LineCallback lineCallback;
+
+    /** @brief FIFO fd, opened for reading and writing */
+    int fd = -1;
+
+    sd_event_source* source = nullptr;
+
+    /** @brief start of a line not terminated yet */
+    std::string partial;
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
@@ -17,6 +17,7 @@
 
 #include "config.h"
 #include "switchtec_fuse.hpp"
+#include "updater_registry.hpp"
 #include <boost/format.hpp>
 #include <iostream>
 #include <cstdio>
@@ -66,6 +67,24 @@ std::string SwitchtecFuse::getModel([
 {
     return "";
 }
+
+namespace
+{
+std::unique_ptr<BaseItemUpdater>
+    createUpdater(sdbusplus::bus::bus& bus, const UpdaterOptions&)
+{
+    return std::make_unique<SwitchtecFuse>(bus);
+}
+} // namespace
+
+constexpr UpdaterDescriptor switchtecUpdater = {
+    .name = "SWITCHTEC",
+    .busName = SWITCHTEC_BUSNAME_UPDATER,
+    .service = SWITCHTEC_FUSE_SERVICE,
+    .timeout = SWITCHTEC_FUSE_TIMEOUT,
+    .factory = createUpdater,
+};
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
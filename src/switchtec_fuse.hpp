@@ -20,6 +20,7 @@
 
 #include "base_item_updater.hpp"
 #include "fstream"
+#include "updater_registry.hpp"
 #include <xyz/openbmc_project/State/Host/server.hpp>
 
 namespace nvidia
@@ -39,7 +40,9 @@ class SwitchtecFuse : public BaseItemUpdater
   public:
     SwitchtecFuse(sdbusplus::bus::bus& bus) :
              BaseItemUpdater(bus, SWITCHTEC_SUPPORTED_MODEL, SWITCHTEC_INVENTORY_IFACE, "PCIE_SWITCH_FUSE",
-                        SWITCHTEC_BUSNAME_UPDATER, SWITCHTEC_FUSE_SERVICE, false, SWITCHTEC_BUSNAME_INVENTORY),
+                        std::string(switchtecUpdater.busName),
+                        std::string(switchtecUpdater.service), false,
+                        SWITCHTEC_BUSNAME_INVENTORY),
              _match(bus, sdbusplus::bus::match::rules::propertiesChanged("/xyz/openbmc_project/state/host0",
                                                                          "xyz.openbmc_project.State.Host"),
                     [this](auto& msg) {
@@ -138,7 +141,7 @@ class SwitchtecFuse : public BaseItemUpdater
      */
     uint32_t getTimeout() override
     {
-        return SWITCHTEC_FUSE_TIMEOUT;
+        return switchtecUpdater.timeout;
     }
 
     /**
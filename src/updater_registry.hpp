@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sdbusplus/bus.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace nvidia
+{
+namespace software
+{
+namespace updater
+{
+
+class BaseItemUpdater;
+
+/**
+ * @brief Command line options an updater factory may use
+ */
+struct UpdaterOptions
+{
+    /** @brief use the single device retimer update, not set by -f yet */
+    bool useFallback = false;
+    /** @brief MTD target */
+    std::string targetName;
+    /** @brief MTD model */
+    std::string modelName;
+};
+
+using UpdaterFactory = std::unique_ptr<BaseItemUpdater> (*)(
+    sdbusplus::bus::bus& bus, const UpdaterOptions& options);
+
+/**
+ * @brief Describes an item updater built into code-manager. Descriptors are
+ *        constant initialized, the updater class reads its bus name, service
+ *        and timeout from its descriptor.
+ */
+struct UpdaterDescriptor
+{
+    /** @brief name selecting the updater on the command line */
+    std::string_view name;
+    /** @brief well-known bus name, prefix for per instance names */
+    std::string_view busName;
+    /** @brief systemd update service */
+    std::string_view service;
+    /** @brief default update timeout in seconds */
+    uint32_t timeout;
+    UpdaterFactory factory;
+};
+
+/** @brief descriptors defined by the updater translation units */
+extern const UpdaterDescriptor psuUpdater;
+extern const UpdaterDescriptor fpgaUpdater;
+extern const UpdaterDescriptor cpldUpdater;
+extern const UpdaterDescriptor retimerUpdater;
+extern const UpdaterDescriptor pexUpdater;
+extern const UpdaterDescriptor orinUpdater;
+extern const UpdaterDescriptor smcuUpdater;
+extern const UpdaterDescriptor debugTokenInstallUpdater;
+extern const UpdaterDescriptor debugTokenEraseUpdater;
+extern const UpdaterDescriptor mtdUpdater;
+extern const UpdaterDescriptor switchtecUpdater;
+extern const UpdaterDescriptor jamplayerUpdater;
+
+/** @class UpdaterRegistry
+ *
+ *  @brief Item updaters built into the binary. The table is a constant
+ *         expression of the descriptors enabled in the build, a new device
+ *         class adds its descriptor under its *_SUPPORT flag.
+ */
+class UpdaterRegistry
+{
+    /** @brief enabled descriptors, nullptr ends the table */
+    static constexpr const UpdaterDescriptor* table[] = {
+#ifdef PSU_SUPPORT
+        &psuUpdater,
+#endif
+#ifdef FPGA_SUPPORT
+        &fpgaUpdater,
+#endif
+#ifdef CPLD_SUPPORT
+        &cpldUpdater,
+#endif
+#ifdef RT_SUPPORT
+        &retimerUpdater,
+#endif
+#ifdef PEX_SUPPORT
+        &pexUpdater,
+#endif
+#ifdef ORIN_FLASH_SUPPORT
+        &orinUpdater,
+#endif
+#ifdef SMCU_FLASH_SUPPORT
+        &smcuUpdater,
+#endif
+#ifdef DEBUG_TOKEN_SUPPORT
+        &debugTokenInstallUpdater,
+        &debugTokenEraseUpdater,
+#endif
+#ifdef MTD_SUPPORT
+        &mtdUpdater,
+#endif
+#ifdef SWITCHTEC_FUSE_SUPPORT
+        &switchtecUpdater,
+#endif
+#ifdef JAMPLAYER_SUPPORT
+        &jamplayerUpdater,
+#endif
+        nullptr,
+    };
+
+  public:
+    /**
+     * @brief Get the descriptors built into the binary
+     *
+     * @return std::span<const UpdaterDescriptor* const>
+     */
+    static constexpr std::span<const UpdaterDescriptor* const> getDescriptors()
+    {
+        return std::span(table).first(std::size(table) - 1);
+    }
+
+    /**
+     * @brief Find the descriptor of a command line name
+     *
+     * @param name
+     * @return const UpdaterDescriptor* - nullptr if not built in
+     */
+    static constexpr const UpdaterDescriptor* find(std::string_view name)
+    {
+        for (const auto* descriptor : getDescriptors())
+        {
+            if (descriptor->name == name)
+            {
+                return descriptor;
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // namespace updater
+} // namespace software
+} // namespace nvidia
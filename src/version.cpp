@@ -23,6 +23,8 @@
 
 #include <openssl/sha.h>
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -40,6 +42,12 @@ using namespace sdbusplus::xyz::openbmc_project::Common::Error;
 
 const std::string transferFailed{"Update.1.0.TransferFailed"};
 
+/** @brief minimum interval between two progress updates on D-Bus */
+constexpr auto progressPublishInterval = std::chrono::seconds(1);
+
+/** @brief upper bound of the backoff between update attempts */
+constexpr auto maxRetryDelay = std::chrono::minutes(5);
+
 void Delete::delete_()
 {
     if (parent.eraseCallback)
@@ -64,6 +72,7 @@ auto Version::activation(Activations value) -> Activations
     else
     {
         activationProgress.reset();
+        activationEstimate.reset();
     }
 
     return SoftwareActivation::activation(value);
@@ -85,88 +94,440 @@ auto Version::requestedActivation(RequestedActivations value)
     return SoftwareActivation::requestedActivation(value);
 }
 
-void Version::unitStateChange(sdbusplus::message::message& msg)
+void Version::unitStateChange(const std::string& jobPath,
+                              const std::string& newStateResult)
 {
-    uint32_t newStateID{};
-    sdbusplus::message::object_path newStateObjPath;
-    std::string newStateUnit{};
-    std::string newStateResult{};
-
-    // Read the msg and populate each variable
-    msg.read(newStateID, newStateObjPath, newStateUnit, newStateResult);
-
-    if (newStateUnit == deviceUpdateUnit)
+    jobSubscriptions.erase(jobPath);
+    auto job = inFlightJobs.find(jobPath);
+    if (job == inFlightJobs.end())
     {
-        if (newStateResult == "done")
-        {
-            onUpdateDone();
-        }
-        if (newStateResult == "failed" || newStateResult == "dependency")
-        {
-            onUpdateFailed();
-        }
+        return;
+    }
+    if (newStateResult == "done")
+    {
+        auto device = job->second;
+        inFlightJobs.erase(job);
+        onUpdateDone(device);
+    }
+    else if (newStateResult == "failed" || newStateResult == "dependency")
+    {
+        auto device = job->second;
+        inFlightJobs.erase(job);
+        onUpdateFailed(device);
+        doUpdate();
     }
 }
 
+bool Version::isUpdateInFlight(const std::string& inventoryPath) const
+{
+    return std::any_of(inFlightJobs.begin(), inFlightJobs.end(),
+                       [&inventoryPath](const auto& job) {
+                           return job.second == inventoryPath;
+                       });
+}
+
 bool Version::doUpdate(const std::string& inventoryPath)
 {
-    currentUpdatingDevice = inventoryPath;
-    deviceUpdateUnit = getUpdateService(currentUpdatingDevice);
+    auto& trace = itemUpdaterUtils->getActivationTrace();
+    auto queued = queuedAt.find(inventoryPath);
+    if (queued != queuedAt.end())
+    {
+        trace.record(versionId, inventoryPath, TracePhase::QueueWait,
+                     queued->second);
+        queuedAt.erase(queued);
+    }
+    deviceOutcomes->addAttempt(inventoryPath);
+    auto deviceUpdateUnit = getUpdateService(inventoryPath);
+    auto start = ActivationTrace::Clock::now();
+    // The FIFO has to exist before the tool looks for it
+    openStatusChannel(inventoryPath, deviceUpdateUnit);
     try
     {
         auto method = bus.new_method_call(SYSTEMD_BUSNAME, SYSTEMD_PATH,
                                           SYSTEMD_INTERFACE, "StartUnit");
         method.append(deviceUpdateUnit, "replace");
-        bus.call_noreply(method);
-        startTimer(itemUpdaterUtils->getTimeout());
+        auto reply = bus.call(method);
+        // JobRemoved of this job is dispatched only after we return to the
+        // event loop, so registering it here cannot miss the completion
+        sdbusplus::message::object_path job;
+        reply.read(job);
+        jobSubscriptions[job.str] = signalRouter->jobRemoved(
+            job.str, [this](const std::string& jobPath,
+                            const std::string& result) {
+                unitStateChange(jobPath, result);
+            });
+        trace.record(versionId, inventoryPath, TracePhase::UnitStart, start);
+        flashStartedAt[inventoryPath] = ActivationTrace::Clock::now();
+        inFlightJobs.emplace(job.str, inventoryPath);
+        startTimer(inventoryPath, itemUpdaterUtils->getAdaptiveTimeout(
+                                     inventoryPath, getImageSize()));
         return true;
     }
     catch (const SdBusError& e)
     {
         log<level::ERR>("Error staring service", entry("ERROR=%s", e.what()));
-        onUpdateFailed();
+        trace.record(versionId, inventoryPath, TracePhase::UnitStart, start,
+                     false);
         return false;
     }
 }
 
+void Version::openStatusChannel(const std::string& inventoryPath,
+                                const std::string& unit)
+{
+    statusChannels.erase(inventoryPath);
+    if (FLASH_STALL_TIMEOUT == 0)
+    {
+        return;
+    }
+    try
+    {
+        statusChannels[inventoryPath] = std::make_unique<StatusChannel>(
+            unit, [this, inventoryPath](const std::string& line) {
+                onUnitStatus(inventoryPath, line);
+            });
+    }
+    catch (const std::exception& e)
+    {
+        log<level::WARNING>("Unable to create status channel",
+                            entry("device=%s", inventoryPath.c_str()),
+                            entry("ERROR=%s", e.what()));
+    }
+}
+
+void Version::onUnitStatus(const std::string& inventoryPath,
+                           const std::string& line)
+{
+    if (!isUpdateInFlight(inventoryPath))
+    {
+        return;
+    }
+    // The unit is alive, it gets at least the stall timeout to report again
+    // but keeps what is left of its update timeout
+    auto timer = deviceTimers.find(inventoryPath);
+    auto deadline = deviceDeadlines.find(inventoryPath);
+    if (timer != deviceTimers.end() && deadline != deviceDeadlines.end())
+    {
+        auto now = ActivationTrace::Clock::now();
+        auto stall = std::chrono::seconds(FLASH_STALL_TIMEOUT);
+        if (deadline->second - now < stall)
+        {
+            timer->second->start(stall, false);
+            deadline->second = now + stall;
+        }
+    }
+    if (auto fraction = StatusChannel::parseProgress(line))
+    {
+        progressEstimator.update(inventoryPath, *fraction,
+                                 ActivationTrace::Clock::now());
+        publishProgress(false);
+    }
+}
+
+void Version::publishProgress(bool force)
+{
+    if (!activationProgress)
+    {
+        return;
+    }
+    auto now = ActivationTrace::Clock::now();
+    auto elapsed = now - lastProgressPublish;
+    if (!force && elapsed < progressPublishInterval)
+    {
+        if (!progressTimer->isRunning())
+        {
+            progressTimer->start(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    progressPublishInterval - elapsed),
+                false);
+        }
+        return;
+    }
+    progressTimer->stop();
+    lastProgressPublish = now;
+    // Queueing took the first 10%, finishing takes the last 10%
+    auto progress =
+        static_cast<uint8_t>(10 + 80 * progressEstimator.getFraction());
+    activationProgress->progress(
+        std::max(activationProgress->progress(), progress));
+    if (activationEstimate)
+    {
+        auto remaining = progressEstimator.getRemaining(now);
+        activationEstimate->remainingTime(remaining ? remaining->count()
+                                                    : -1);
+    }
+}
+
 bool Version::doUpdate()
 {
-    // When the queue is empty, all updates are done
-    if (deviceQueue.empty())
+    bool started = true;
+    size_t maxJobs =
+        std::max<uint32_t>(itemUpdaterUtils->maxParallelUpdates(), 1);
+    std::vector<std::string> failed;
+    do
     {
-        finishActivation();
-        return true;
+        // Failures are handled once the queues are not iterated anymore,
+        // the slots they free are filled in the next round
+        for (const auto& device : failed)
+        {
+            onUpdateFailed(device);
+        }
+        failed.clear();
+        // Fill the free update slots with the next device of every idle bus
+        for (auto& [lane, queue] : deviceQueue)
+        {
+            if (inFlightJobs.size() >= maxJobs)
+            {
+                break;
+            }
+            if (queue.empty() || busyLanes.contains(lane))
+            {
+                continue;
+            }
+            auto device = queue.front();
+            queue.pop();
+            queuedDevices--;
+            busyLanes.insert(lane);
+            if (!doUpdate(device))
+            {
+                failed.push_back(device);
+                started = false;
+            }
+        }
+    } while (!failed.empty());
+
+    // When nothing is queued, running or waiting, all updates are done
+    if (queuedDevices == 0 && inFlightJobs.empty() && retryingDevices.empty())
+    {
+        if (deviceOutcomes->anyFailed())
+        {
+            failActivation();
+        }
+        else
+        {
+            finishActivation();
+        }
+    }
+    return started;
+}
+
+std::string Version::getUpdateLane(const std::string& inventoryPath) const
+{
+    // Devices on the same bus are updated one after the other, devices
+    // without a known bus are independent from each other
+    auto deviceBus = itemUpdaterUtils->getDeviceBus(inventoryPath);
+    if (deviceBus)
+    {
+        return "bus" + std::to_string(*deviceBus);
     }
+    return inventoryPath;
+}
 
-    // Do the update on a device
-    const auto& device = deviceQueue.front();
-    return doUpdate(device);
+uintmax_t Version::getImageSize() const
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path(), ec);
+    return ec ? 0 : size;
 }
 
-void Version::onUpdateDone()
+void Version::onUpdateDone(const std::string& inventoryPath)
 {
+    auto timer = deviceTimers.find(inventoryPath);
+    if (timer != deviceTimers.end())
+    {
+        timer->second->stop();
+    }
+    statusChannels.erase(inventoryPath);
+    deviceDeadlines.erase(inventoryPath);
+    busyLanes.erase(getUpdateLane(inventoryPath));
+    auto flash = flashStartedAt.find(inventoryPath);
+    if (flash != flashStartedAt.end())
+    {
+        itemUpdaterUtils->getActivationTrace().record(
+            versionId, inventoryPath, TracePhase::Flash, flash->second);
+        itemUpdaterUtils->recordFlashDuration(
+            inventoryPath, getImageSize(),
+            std::chrono::duration_cast<std::chrono::seconds>(
+                ActivationTrace::Clock::now() - flash->second));
+        flashStartedAt.erase(flash);
+    }
+    // The device runs the new image now
+    deviceOutcomes->set(inventoryPath, DeviceOutcome::Updated);
+    for (const auto& device : getUnitDevices(inventoryPath))
+    {
+        itemUpdaterUtils->invalidateDeviceSnapshot(device);
+        itemUpdaterUtils->setFlashedDigest(device, getImageDigest());
+    }
     if (activationProgress)
     {
-        auto progress = activationProgress->progress() + progressStep;
-        activationProgress->progress(progress);
+        progressEstimator.done(inventoryPath, ActivationTrace::Clock::now());
+        publishProgress(true);
 
-        deviceQueue.pop();
         doUpdate(); // Update the next device
     }
 }
 
-void Version::onUpdateFailed()
+void Version::onUpdateFailed(const std::string& inventoryPath)
 {
-    logTransferFailed(itemUpdaterUtils->getName(), extendedVersion());
     log<level::ERR>("Failed to udpate device",
-                    entry("device=%s", deviceQueue.front().c_str()));
-    std::queue<std::string>().swap(deviceQueue); // Clear the queue
+                    entry("device=%s", inventoryPath.c_str()));
+    auto timer = deviceTimers.find(inventoryPath);
+    if (timer != deviceTimers.end())
+    {
+        // The timer is not destroyed as this may run from its callback
+        timer->second->stop();
+    }
+    if (isUpdateInFlight(inventoryPath))
+    {
+        // Timed out, the completion of the job is ignored from now on
+        std::erase_if(inFlightJobs, [&inventoryPath](const auto& job) {
+            return job.second == inventoryPath;
+        });
+        stopUnit(getUpdateService(inventoryPath));
+    }
+    statusChannels.erase(inventoryPath);
+    deviceDeadlines.erase(inventoryPath);
+    busyLanes.erase(getUpdateLane(inventoryPath));
+    auto flash = flashStartedAt.find(inventoryPath);
+    if (flash != flashStartedAt.end())
+    {
+        itemUpdaterUtils->getActivationTrace().record(
+            versionId, inventoryPath, TracePhase::Flash, flash->second, false);
+        flashStartedAt.erase(flash);
+    }
+    // A partially written device runs neither the old nor the new image
+    for (const auto& device : getUnitDevices(inventoryPath))
+    {
+        itemUpdaterUtils->invalidateDeviceSnapshot(device);
+        itemUpdaterUtils->setFlashedDigest(device, "");
+    }
+    if (activationProgress)
+    {
+        progressEstimator.failed(inventoryPath, ActivationTrace::Clock::now());
+    }
+
+    auto attempts = deviceOutcomes->getAttempts(inventoryPath);
+    if (attempts <= UPDATE_RETRY_LIMIT)
+    {
+        scheduleRetry(inventoryPath, attempts);
+        return;
+    }
+    log<level::ERR>("Giving up updating device",
+                    entry("device=%s", inventoryPath.c_str()),
+                    entry("ATTEMPTS=%u", attempts));
+    deviceOutcomes->set(inventoryPath, DeviceOutcome::Failed);
+    logTransferFailed(itemUpdaterUtils->getName(), extendedVersion());
+}
+
+void Version::scheduleRetry(const std::string& inventoryPath,
+                            uint32_t attempts)
+{
+    // The backoff doubles with every failed attempt
+    auto delay = std::min<std::chrono::seconds>(
+        std::chrono::seconds(UPDATE_RETRY_DELAY) *
+            (1u << std::min(attempts - 1, 8u)),
+        maxRetryDelay);
+    log<level::WARNING>("Retrying device update",
+                        entry("device=%s", inventoryPath.c_str()),
+                        entry("ATTEMPT=%u", attempts + 1),
+                        entry("DELAY=%lld",
+                              static_cast<long long>(delay.count())));
+    deviceOutcomes->set(inventoryPath, DeviceOutcome::Retrying);
+    retryingDevices.insert(inventoryPath);
+    auto& timer = retryTimers[inventoryPath];
+    if (!timer)
+    {
+        timer = std::make_unique<sdbusplus::Timer>(
+            [this, inventoryPath]() { retryDevice(inventoryPath); });
+    }
+    timer->start(delay, false);
+}
+
+void Version::retryDevice(const std::string& inventoryPath)
+{
+    if (retryingDevices.erase(inventoryPath) == 0)
+    {
+        return;
+    }
+    deviceQueue[getUpdateLane(inventoryPath)].push(inventoryPath);
+    queuedAt[inventoryPath] = ActivationTrace::Clock::now();
+    queuedDevices++;
+    deviceOutcomes->set(inventoryPath, DeviceOutcome::Queued);
+    doUpdate();
+}
+
+void Version::stopUnit(const std::string& unit)
+{
+    try
+    {
+        auto method = bus.new_method_call(SYSTEMD_BUSNAME, SYSTEMD_PATH,
+                                          SYSTEMD_INTERFACE, "StopUnit");
+        method.append(unit, "replace");
+        callAsync(method, [unit](sdbusplus::message::message& reply) {
+            if (reply.is_method_error())
+            {
+                log<level::WARNING>("Unable to stop update service",
+                                    entry("UNIT=%s", unit.c_str()));
+            }
+        });
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Error stopping service",
+                        entry("ERROR=%s", e.what()));
+    }
+}
+
+void Version::failActivation()
+{
+    itemUpdaterUtils->getActivationTrace().record(
+        versionId, "", TracePhase::Activation, activationStartedAt, false);
+    queuedAt.clear();
+    flashStartedAt.clear();
+    deviceQueue.clear();
+    queuedDevices = 0;
+    busyLanes.clear();
+    inFlightJobs.clear();
+    retryingDevices.clear();
+    // The timers are not destroyed as this may run from a timer callback
+    for (auto& [device, timer] : deviceTimers)
+    {
+        timer->stop();
+    }
+    for (auto& [device, timer] : retryTimers)
+    {
+        timer->stop();
+    }
+    statusChannels.clear();
+    if (progressTimer)
+    {
+        progressTimer->stop();
+    }
     activation(Status::Failed);
-    std::filesystem::remove(path());
-    itemUpdaterUtils->readExistingFirmWare();
+    // The devices updated already are not flashed again when the activation
+    // is requested once more, so the image is kept for it
+    imageRetained = true;
+    // Only the devices written to may run another version now
+    for (auto outcome : {DeviceOutcome::Updated, DeviceOutcome::Failed})
+    {
+        for (const auto& device : deviceOutcomes->find(outcome))
+        {
+            itemUpdaterUtils->refreshDevice(device);
+        }
+    }
     requestedActivation(SoftwareActivation::RequestedActivations::None);
 }
 
+void Version::removeRetainedImage()
+{
+    if (imageRetained)
+    {
+        std::error_code ec;
+        std::filesystem::remove(path(), ec);
+        imageRetained = false;
+    }
+}
+
 Version::Status Version::startActivation()
 {
     // Check if the activation has file path
@@ -177,25 +538,132 @@ Version::Status Version::startActivation()
         return activation(); // Return the previous activation status
     }
 
-    auto devicePaths = itemUpdaterUtils->getItemUpdaterInventoryPaths();
-    if (devicePaths.empty())
+    if (!deviceOutcomes)
+    {
+        deviceOutcomes = std::make_unique<DeviceOutcomes>(bus, objPath);
+    }
+    if (activation() == Status::Failed)
+    {
+        log<level::NOTICE>("Resuming failed activation",
+                           entry("VERSION_ID=%s", getVersionId().c_str()));
+        deviceOutcomes->resume();
+    }
+    else
+    {
+        deviceOutcomes->clear();
+    }
+
+    deviceQueue.clear();
+    queuedDevices = 0;
+    skippedDevices = 0;
+    busyLanes.clear();
+    inFlightJobs.clear();
+    retryingDevices.clear();
+    for (auto& [device, timer] : retryTimers)
     {
-        log<level::WARNING>("No device inventory found");
-        return Status::Failed;
+        timer->stop();
     }
+    deviceTimers.clear();
+    statusChannels.clear();
+    queuedAt.clear();
+    flashStartedAt.clear();
+    activationStartedAt = ActivationTrace::Clock::now();
+
     // apply target filtering
     targetFilter =
         itemUpdaterUtils->applyTargetFilters(updatePolicy->targets());
-    for (const auto& p : devicePaths)
+    if (!activationProgress)
+    {
+        activationProgress = std::make_unique<ActivationProgress>(bus, objPath);
+    }
+    if (!activationEstimate)
+    {
+        activationEstimate = std::make_unique<ActivationEstimate>(bus, objPath);
+    }
+    if (!progressTimer)
     {
-        if (isCompatible(p))
+        progressTimer = std::make_unique<sdbusplus::Timer>(
+            [this]() { publishProgress(true); });
+    }
+    progressTimer->stop();
+
+    // Inventory and compatibility are looked up asynchronously, the
+    // activation stays in Activating until the devices are queued
+    activationToken = std::make_shared<bool>(true);
+    std::weak_ptr<bool> token = activationToken;
+    itemUpdaterUtils->getItemUpdaterInventoryPathsAsync(
+        [this, token](std::vector<std::string> devicePaths) {
+            if (token.expired())
+            {
+                return;
+            }
+            if (devicePaths.empty())
+            {
+                log<level::WARNING>("No device inventory found");
+                activation(Status::Failed);
+                return;
+            }
+            if (itemUpdaterUtils->updateAllTogether())
+            {
+                unitDevices = devicePaths;
+            }
+            queueCompatibleDevices(
+                std::make_shared<std::vector<std::string>>(
+                    std::move(devicePaths)),
+                0, token);
+        });
+    return Status::Activating;
+}
+
+void Version::queueCompatibleDevices(
+    std::shared_ptr<std::vector<std::string>> devicePaths, size_t index,
+    std::weak_ptr<bool> token)
+{
+    if (index >= devicePaths->size())
+    {
+        startQueuedUpdates();
+        return;
+    }
+    const auto& p = (*devicePaths)[index];
+    auto onChecked = [this, devicePaths, index, token](bool compatible) {
+        const auto& p = (*devicePaths)[index];
+        bool updated = deviceOutcomes->get(p) == DeviceOutcome::Updated;
+        if (updated && !isRunningImage(p))
+        {
+            // Another image was flashed or the device was replaced since
+            log<level::NOTICE>("device no longer runs the image of the "
+                               "failed activation",
+                               entry("device=%s", p.c_str()));
+            deviceOutcomes->erase(p);
+            updated = false;
+        }
+        if (compatible && updated)
+        {
+            log<level::NOTICE>("device updated by the failed activation, "
+                               "skipped",
+                               entry("device=%s", p.c_str()));
+            skippedDevices++;
+        }
+        else if (compatible && !updatePolicy->forceUpdate() &&
+                 isRunningImage(p))
         {
-            deviceQueue.push(p);
+            log<level::NOTICE>("device already runs the image, skipped",
+                               entry("device=%s", p.c_str()));
+            deviceOutcomes->set(p, DeviceOutcome::Skipped);
+            skippedDevices++;
+        }
+        else if (compatible)
+        {
+            deviceOutcomes->set(p, DeviceOutcome::Queued);
+            deviceQueue[getUpdateLane(p)].push(p);
+            queuedAt[p] = ActivationTrace::Clock::now();
+            queuedDevices++;
             if (itemUpdaterUtils->updateAllTogether())
             {
                 log<level::NOTICE>("Updating all devices under",
                                    entry("device=%s", p.c_str()));
-                break;
+                startQueuedUpdates();
+                return;
             }
         }
         else
@@ -203,40 +671,86 @@ Version::Status Version::startActivation()
             log<level::NOTICE>("device not compatible",
                                entry("device=%s", p.c_str()));
         }
-    }
-    if (deviceQueue.empty())
+        queueCompatibleDevices(devicePaths, index + 1, token);
+    };
+    // few other device updater like retimer, debug token does not have
+    // inventory, skip compatibility check for those
+    if (!itemUpdaterUtils->inventorySupported())
     {
-        log<level::WARNING>("No device compatible with the software");
-        progressStep = 90;
+        onChecked(true);
+        return;
     }
-    else
+    auto start = ActivationTrace::Clock::now();
+    itemUpdaterUtils->getInventorySnapshotAsync(
+        p, [this, token, onChecked, p, start](const DeviceSnapshot& snapshot) {
+            if (token.expired())
+            {
+                return;
+            }
+            auto compatible = isCompatible(snapshot);
+            itemUpdaterUtils->getActivationTrace().record(
+                versionId, p, TracePhase::CompatibilityCheck, start,
+                compatible);
+            onChecked(compatible);
+        });
+}
+
+bool Version::isRunningImage(const std::string& inventoryPath)
+{
+    // The version string is the name of the uploaded file, not the version
+    // inside the image, so only an image code-manager flashed is known
+    if (getImageDigest().empty())
     {
-        progressStep = 80 / deviceQueue.size();
+        return false;
     }
+    auto devices = getUnitDevices(inventoryPath);
+    return std::all_of(devices.begin(), devices.end(),
+                       [this](const std::string& device) {
+                           return itemUpdaterUtils->getDeviceSnapshot(device)
+                                      .flashedDigest == getImageDigest();
+                       });
+}
 
-    if (!activationProgress)
+std::vector<std::string>
+    Version::getUnitDevices(const std::string& inventoryPath) const
+{
+    if (itemUpdaterUtils->updateAllTogether() && !unitDevices.empty())
     {
-        activationProgress = std::make_unique<ActivationProgress>(bus, objPath);
+        return unitDevices;
     }
-    if (targetFilter.type == TargetFilterType::UpdateNone)
+    return {inventoryPath};
+}
+
+void Version::startQueuedUpdates()
+{
+    if (queuedDevices == 0 && skippedDevices > 0)
     {
-        finishActivation();
-        return Status::Active;
+        log<level::NOTICE>("All devices already run the software");
     }
-    if (doUpdate())
+    else if (queuedDevices == 0)
     {
-        activationProgress->progress(10);
-        return Status::Activating;
+        log<level::WARNING>("No device compatible with the software");
     }
-    else
+
+    if (targetFilter.type == TargetFilterType::UpdateNone)
     {
-        return Status::Failed;
+        finishActivation();
+        return;
     }
+    activationProgress->progress(10);
+    progressEstimator.start(queuedDevices, ActivationTrace::Clock::now());
+    // A failed start is reported by onUpdateFailed
+    doUpdate();
 }
 
 void Version::finishActivation()
 {
+    itemUpdaterUtils->getActivationTrace().record(
+        versionId, "", TracePhase::Activation, activationStartedAt);
     activationProgress->progress(100);
+    activationEstimate->remainingTime(0);
+    progressTimer->stop();
+    imageRetained = false;
     // Reset RequestedActivations to none so that it could be activated in
     // future
     requestedActivation(SoftwareActivation::RequestedActivations::None);
@@ -244,32 +758,15 @@ void Version::finishActivation()
     //remove file
     std::filesystem::remove(path());
 }
-bool Version::isCompatible(const std::string& inventoryPath)
+bool Version::isCompatible(const DeviceSnapshot& snapshot)
 {
-    std::string deviceManufacturer;
-    std::string deviceModel;
-    // few other device updater like retimer, debug token does not have
-    // inventory, skip compatibility check for those
-    if (!itemUpdaterUtils->inventorySupported())
-    {
-        return true;
-    }
-    try
-    {
-        auto service =
-            itemUpdaterUtils->getDbusService(inventoryPath, ASSET_IFACE);
-        deviceManufacturer = getProperty<std::string>(
-            service.c_str(), inventoryPath.c_str(), ASSET_IFACE, MANUFACTURER);
-        deviceModel = getProperty<std::string>(
-            service.c_str(), inventoryPath.c_str(), ASSET_IFACE, MODEL);
-    }
     // For Retimer model is hardcoded by GpuMgr. Ignore for retimer
     // For Retimer manufacturer is not populated by GpuMgr. Ignore for retimer
-    catch (const std::exception& e)
+    const auto& deviceManufacturer = snapshot.inventoryManufacturer;
+    const auto& deviceModel = snapshot.inventoryModel;
+    if (!snapshot.inventoryRead)
     {
-        log<level::INFO>("Error while getting inventory properties",
-                         entry("ERROR=%s", e.what()));
-        std::cerr << e.what() << '\n';
+        log<level::INFO>("Error while getting inventory properties");
     }
 
     // ignore if deviceModel is empty from GPU manager else it should match
@@ -19,6 +19,10 @@
 
 #include "activation_listener.hpp"
 #include "dbusutils.hpp"
+#include "image_digest.hpp"
+#include "device_outcomes.hpp"
+#include "progress_estimator.hpp"
+#include "status_channel.hpp"
 #include "version.hpp"
 #include "xyz/openbmc_project/Common/FilePath/server.hpp"
 #include "xyz/openbmc_project/Common/UUID/server.hpp"
@@ -42,7 +46,9 @@
 
 #include <functional>
 #include <iostream>
+#include <map>
 #include <queue>
+#include <set>
 #include <string>
 
 namespace nvidia
@@ -58,10 +64,6 @@ namespace sdbusRule = sdbusplus::bus::match::rules;
 
 typedef std::function<void(std::string)> eraseFunc;
 
-using PropertyType = std::variant<std::string, bool>;
-
-using Properties = std::map<std::string, PropertyType>;
-
 using ActivationProgressInherit = sdbusplus::server::object::object<
     sdbusplus::xyz::openbmc_project::Software::server::ActivationProgress>;
 
@@ -246,14 +248,7 @@ class Version : public VersionInherit, public DBUSUtils
                        VersionInherit::action::defer_emit),
         DBUSUtils(bus), eraseCallback(callback), versionId(versionId),
         objPath(objPath), model(model), manufacturer(manufacturer),
-        verstionStr(versionString),
-        systemdSignals(
-            bus,
-            sdbusRule::type::signal() + sdbusRule::member("JobRemoved") +
-                sdbusRule::path("/org/freedesktop/systemd1") +
-                sdbusRule::interface("org.freedesktop.systemd1.Manager"),
-            std::bind(&Version::unitStateChange, this, std::placeholders::_1)),
-        activationListener(activationListener),
+        verstionStr(versionString), activationListener(activationListener),
         itemUpdaterUtils(itemUpdaterUtils)
     {
         // Set properties.
@@ -264,9 +259,13 @@ class Version : public VersionInherit, public DBUSUtils
 
         activationProgress = nullptr;
         updatePolicy = std::make_unique<UpdatePolicy>(bus, objPath);
+#ifdef SKIP_IDENTICAL_UPDATES
+        // Devices already running the image are skipped unless forced
+        updatePolicy->forceUpdate(false);
+#else
         updatePolicy->forceUpdate(true);
+#endif
         deleteObject = std::make_unique<Delete>(bus, objPath, *this);
-        timer = nullptr;
         // Emit deferred signal.
         emit_object_added();
     }
@@ -301,6 +300,59 @@ class Version : public VersionInherit, public DBUSUtils
         return verstionStr;
     }
 
+    /**
+     * @brief Get the digest of the image, empty if the version has no image
+     *
+     * @return const std::string&
+     */
+    const std::string& getImageDigest() const
+    {
+        return imageDigest;
+    }
+
+    /**
+     * @brief Set the digest of the image computed when it was uploaded
+     *
+     * @param digest - hex digest
+     */
+    void setImageDigest(const std::string& digest)
+    {
+        imageDigest = digest;
+        if (!digest.empty())
+        {
+            digestInterface = std::make_unique<ImageDigestInterface>(
+                bus, objPath, digest, IMAGE_DIGEST_ALGORITHM);
+        }
+    }
+
+    /**
+     * @brief Removes the image kept by a failed activation for resuming it
+     *
+     */
+    void removeRetainedImage();
+
+    /**
+     * @brief Hands the retained image over to a new upload of the same
+     * file, it is not removed with this version
+     *
+     */
+    void releaseRetainedImage()
+    {
+        imageRetained = false;
+    }
+
+    /**
+     * @brief Checks whether the image file is still needed, by a running
+     * activation or for resuming a failed one
+     *
+     * @return true
+     * @return false
+     */
+    bool isImageInUse() const
+    {
+        return imageRetained || activation() == Status::Activating;
+    }
+
     /** @brief Activation */
     using VersionInherit::activation;
 
@@ -348,11 +400,13 @@ class Version : public VersionInherit, public DBUSUtils
 
   private:
     /**
-     * @brief unit state change callback
+     * @brief unit state change callback, routed by the shared JobRemoved
+     * subscription
      *
-     * @param msg
+     * @param job - job object path
+     * @param result - job result
      */
-    void unitStateChange(sdbusplus::message::message& msg);
+    void unitStateChange(const std::string& job, const std::string& result);
 
     /**
      * @brief calls update systemd service
@@ -365,42 +419,143 @@ class Version : public VersionInherit, public DBUSUtils
 
     /**
      * @brief Timeout handler for non-pldm updates. This method
-     *        sets the status to failed if update did not complete
-     *        within specified time.
+     *        sets the status to failed if the update of the device did not
+     *        complete within specified time. A report of the unit through
+     *        its status channel extends the timer to at least the stall
+     *        timeout, it never shortens the time left.
      *
+     * @param inventoryPath
      * @param timeout
      */
-    inline void startTimer(uint32_t timeout)
+    inline void startTimer(const std::string& inventoryPath, uint32_t timeout)
     {
-        timer = std::make_unique<sdbusplus::Timer>([this]() {
-            if (!deviceQueue.empty())
+        auto timer = std::make_unique<sdbusplus::Timer>([this,
+                                                         inventoryPath]() {
+            if (isUpdateInFlight(inventoryPath))
             {
-                log<level::ERR>("Update timed out");
-                this->onUpdateFailed();
+                log<level::ERR>("Update timed out",
+                                entry("device=%s", inventoryPath.c_str()));
+                this->onUpdateFailed(inventoryPath);
+                this->doUpdate();
             }
         });
         timer->start(std::chrono::seconds(timeout), false);
+        deviceTimers[inventoryPath] = std::move(timer);
+        deviceDeadlines[inventoryPath] =
+            ActivationTrace::Clock::now() + std::chrono::seconds(timeout);
     }
 
     /**
-     * @brief calls update services for all inventory paths
+     * @brief Creates the status channel of the update unit of the device, a
+     *        failure leaves the device covered by its timer only
+     *
+     * @param inventoryPath
+     * @param unit - name of the update unit
+     */
+    void openStatusChannel(const std::string& inventoryPath,
+                           const std::string& unit);
+
+    /**
+     * @brief Handles a line reported by the update unit of the device, every
+     *        line is a heartbeat
      *
+     * @param inventoryPath
+     * @param line
+     */
+    void onUnitStatus(const std::string& inventoryPath,
+                      const std::string& line);
+
+    /**
+     * @brief Publishes the estimated progress and time left. Updates closer
+     *        than the publish interval to the last one are held back and
+     *        published by a timer.
+     *
+     * @param force - publish now, regardless of the interval
+     */
+    void publishProgress(bool force);
+
+    /**
+     * @brief Checks whether an update job is running for the device
+     *
+     * @param inventoryPath
      * @return true
      * @return false
      */
+    bool isUpdateInFlight(const std::string& inventoryPath) const;
+
+    /**
+     * @brief starts update services for queued inventory paths, keeping at
+     *        most maxParallelUpdates() jobs and one job per lane in flight.
+     *        Once no device is queued, running or waiting for a retry the
+     *        activation is finished, or failed if a device failed.
+     *
+     * @return true
+     * @return false - if an update service could not be started
+     */
     bool doUpdate();
 
+    /**
+     * @brief Get the update lane of the device. Only one device of a lane
+     *        is updated at a time.
+     *
+     * @param inventoryPath
+     * @return std::string
+     */
+    std::string getUpdateLane(const std::string& inventoryPath) const;
+
+    /**
+     * @brief Get the size of the image file, the flash history of a device
+     *        is kept per image size
+     *
+     * @return uintmax_t - 0 if the file is missing
+     */
+    uintmax_t getImageSize() const;
+
     /**
      * @brief Call back for systemd service
      *
+     * @param inventoryPath
+     */
+    void onUpdateDone(const std::string& inventoryPath);
+
+    /**
+     * @brief Call back for systemd service fail. The device is tried again
+     *        after a backoff until UPDATE_RETRY_LIMIT retries failed, the
+     *        other devices are not affected. The caller continues with
+     *        doUpdate().
+     *
+     * @param inventoryPath
+     */
+    void onUpdateFailed(const std::string& inventoryPath);
+
+    /**
+     * @brief Queues the device again once its backoff elapsed
+     *
+     * @param inventoryPath
+     * @param attempts - attempts failed so far
      */
-    void onUpdateDone();
+    void scheduleRetry(const std::string& inventoryPath, uint32_t attempts);
 
     /**
-     * @brief Call back for systemd service fail
+     * @brief Retry timer handler, queues the device and starts the update
      *
+     * @param inventoryPath
      */
-    void onUpdateFailed();
+    void retryDevice(const std::string& inventoryPath);
+
+    /**
+     * @brief Stops an update service that timed out
+     *
+     * @param unit
+     */
+    void stopUnit(const std::string& unit);
+
+    /**
+     * @brief Marks the activation Failed, the image is kept so that a new
+     *        activation resumes with the devices not updated yet
+     *
+     */
+    void failActivation();
 
     /**
      * @brief Prepares for image update
@@ -416,13 +571,51 @@ class Version : public VersionInherit, public DBUSUtils
     void finishActivation();
 
     /**
-     * @brief Checks image compatibility
+     * @brief Queues the compatible devices, devices are checked one after
+     * another without blocking the event loop
+     *
+     * @param devicePaths
+     * @param index - next device to check
+     * @param token - token of the activation the check belongs to
+     */
+    void queueCompatibleDevices(
+        std::shared_ptr<std::vector<std::string>> devicePaths, size_t index,
+        std::weak_ptr<bool> token);
+
+    /**
+     * @brief Checks if the devices updated by the unit of the device already
+     * run the image, by the digest of the image last flashed to them
+     *
+     * @param inventoryPath
+     * @return true
+     * @return false
+     */
+    bool isRunningImage(const std::string& inventoryPath);
+
+    /**
+     * @brief Get the devices written by the update unit of the device, all
+     * devices of the updater when they are updated together
      *
      * @param inventoryPath
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string>
+        getUnitDevices(const std::string& inventoryPath) const;
+
+    /**
+     * @brief Starts updating the queued devices
+     *
+     */
+    void startQueuedUpdates();
+
+    /**
+     * @brief Checks image compatibility
+     *
+     * @param snapshot - snapshot of the device inventory
      * @return true
      * @return false
      */
-    bool isCompatible(const std::string& inventoryPath);
+    bool isCompatible(const DeviceSnapshot& snapshot);
 
     /**
      * @brief Moves images to persistant path
@@ -474,18 +667,43 @@ class Version : public VersionInherit, public DBUSUtils
 
     std::string verstionStr;
 
-    sdbusplus::bus::match_t systemdSignals;
+    std::string imageDigest;
+
+    std::unique_ptr<ImageDigestInterface> digestInterface;
+
+    /** @brief devices of the updater when they are updated together */
+    std::vector<std::string> unitDevices;
+
+    /** @brief JobRemoved subscriptions of the started update jobs */
+    std::map<std::string, SignalRouter::Subscription> jobSubscriptions;
+
+    /** @brief devices waiting for update, grouped by update lane */
+    std::map<std::string, std::queue<std::string>> deviceQueue;
 
-    std::queue<std::string> deviceQueue;
+    size_t queuedDevices = 0;
 
-    uint32_t progressStep;
+    /** @brief devices left out because they already run the image */
+    size_t skippedDevices = 0;
 
-    std::string deviceUpdateUnit;
+    /** @brief lanes which have an update running */
+    std::set<std::string> busyLanes;
 
-    std::string currentUpdatingDevice;
+    /** @brief systemd job path to inventory path of the running updates */
+    std::map<std::string, std::string> inFlightJobs;
+
+    /** @brief progress of the running activation, fed by device
+     * completions and the reports of the update units */
+    ProgressEstimator progressEstimator;
 
     std::unique_ptr<ActivationProgress> activationProgress;
 
+    std::unique_ptr<ActivationEstimate> activationEstimate;
+
+    /** @brief publishes progress held back by the rate limit */
+    std::unique_ptr<sdbusplus::Timer> progressTimer;
+
+    ActivationTrace::Clock::time_point lastProgressPublish;
+
     std::unique_ptr<UpdatePolicy> updatePolicy;
 
     ActivationListener* activationListener;
@@ -493,7 +711,39 @@ class Version : public VersionInherit, public DBUSUtils
     ItemUpdaterUtils* itemUpdaterUtils;
 
     TargetFilter targetFilter;
-    std::unique_ptr<sdbusplus::Timer> timer;
+
+    std::map<std::string, std::unique_ptr<sdbusplus::Timer>> deviceTimers;
+
+    /** @brief when the device timers expire */
+    std::map<std::string, ActivationTrace::Clock::time_point> deviceDeadlines;
+
+    /** @brief retry timers of the devices whose update failed */
+    std::map<std::string, std::unique_ptr<sdbusplus::Timer>> retryTimers;
+
+    /** @brief devices waiting for their retry timer */
+    std::set<std::string> retryingDevices;
+
+    /** @brief outcome of every device of the last activation */
+    std::unique_ptr<DeviceOutcomes> deviceOutcomes;
+
+    /** @brief the image was kept by a failed activation */
+    bool imageRetained = false;
+
+    /** @brief status channels of the running update units */
+    std::map<std::string, std::unique_ptr<StatusChannel>> statusChannels;
+
+    /** @brief when the devices were queued, for the queue wait spans */
+    std::map<std::string, ActivationTrace::Clock::time_point> queuedAt;
+
+    /** @brief when the update services were started, for the flash spans */
+    std::map<std::string, ActivationTrace::Clock::time_point> flashStartedAt;
+
+    /** @brief when the running activation was requested */
+    ActivationTrace::Clock::time_point activationStartedAt;
+
+    /** @brief renewed by each activation, asynchronous lookups holding an
+     * expired token belong to an older activation and are dropped */
+    std::shared_ptr<bool> activationToken;
 };
 
 } // namespace updater
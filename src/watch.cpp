@@ -26,12 +26,14 @@
 #include <boost/algorithm/string/split.hpp>
 #include <phosphor-logging/log.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 namespace nvidia
 {
 namespace software
@@ -57,28 +59,35 @@ Watch::Watch(sd_event* loop, std::vector<std::filesystem::path> pathsToMonitor,
                                  std::strerror(error));
     }
 
-    for (const std::filesystem::path& path : pathsToMonitor)
+    auto rc = sd_event_add_defer(loop, &dispatchSource, dispatch, this);
+    if (0 > rc)
+    {
+        close(fd);
+        throw std::runtime_error("failed to add to event loop, rc="s +
+                                 std::strerror(-rc));
+    }
+    sd_event_source_set_enabled(dispatchSource, SD_EVENT_OFF);
+    try
     {
-        if (std::filesystem::exists(path))
+        for (const std::filesystem::path& path : pathsToMonitor)
         {
+            // Uploads left over from a previous run may be incomplete, start
+            // from an empty directory. Directories added later are kept.
             std::filesystem::remove_all(path);
+            addPath(path);
         }
-        // Create Directory
-        std::filesystem::create_directories(path);
-        // Add to watch
-        auto wd = inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE);
-        if (-1 == wd)
-        {
-            auto error = errno;
-            close(fd);
-            throw std::runtime_error("inotify_add_watch failed, errno="s +
-                                     std::strerror(error));
-        }
-        wds[wd] = path;
     }
-    auto rc = sd_event_add_io(loop, nullptr, fd, EPOLLIN, callback, this);
+    catch (...)
+    {
+        sd_event_source_unref(dispatchSource);
+        close(fd);
+        throw;
+    }
+    rc = sd_event_add_io(loop, nullptr, fd, EPOLLIN, callback, this);
     if (0 > rc)
     {
+        sd_event_source_unref(dispatchSource);
+        close(fd);
         throw std::runtime_error("failed to add to event loop, rc="s +
                                  std::strerror(-rc));
     }
@@ -86,6 +95,10 @@ Watch::Watch(sd_event* loop, std::vector<std::filesystem::path> pathsToMonitor,
 
 Watch::~Watch()
 {
+    if (dispatchSource)
+    {
+        sd_event_source_unref(dispatchSource);
+    }
     if (-1 != fd)
     {
         for (std::map<int, std::string>::iterator itr = wds.begin();
@@ -104,43 +117,163 @@ int Watch::callback(sd_event_source* /* s */, int fd, uint32_t revents,
     {
         return 0;
     }
+    auto watch = static_cast<Watch*>(userdata);
 
-    constexpr auto maxBytes = 1024;
-    uint8_t buffer[maxBytes];
-    auto bytes = read(fd, buffer, maxBytes);
-    if (0 > bytes)
+    // Large enough for a burst of events, aligned for inotify_event
+    constexpr auto maxBytes = 64 * 1024;
+    alignas(inotify_event) static uint8_t buffer[maxBytes];
+    bool overflow = false;
+    while (true)
     {
-        auto error = errno;
-        throw std::runtime_error("failed to read inotify event, errno="s +
-                                 std::strerror(error));
-    }
-
-    auto offset = 0;
-    while (offset < bytes)
-    {
-        auto event = reinterpret_cast<inotify_event*>(&buffer[offset]);
-        if ((event->mask & IN_CLOSE_WRITE) && !(event->mask & IN_ISDIR))
+        auto bytes = read(fd, buffer, maxBytes);
+        if (0 > bytes)
         {
-            auto parentPath = static_cast<Watch*>(userdata)->wds[event->wd];
-            auto imagePath = parentPath + '/' + event->name;
-            auto rc = static_cast<Watch*>(userdata)->imageCallback(imagePath);
-
-            if (rc < 0)
+            auto error = errno;
+            if (error == EAGAIN || error == EWOULDBLOCK)
+            {
+                break; // drained
+            }
+            if (error == EINTR)
             {
-                log<level::ERR>("Error processing image",
-                                entry("IMAGE=%s", imagePath.c_str()));
+                continue;
             }
+            throw std::runtime_error("failed to read inotify event, errno="s +
+                                     std::strerror(error));
         }
-        offset += offsetof(inotify_event, name) + event->len;
-        if (0 >= offset) // check to ensure tainted input from buffer
+        if (0 == bytes)
         {
             break;
         }
+
+        ssize_t offset = 0;
+        while (offset + static_cast<ssize_t>(sizeof(inotify_event)) <= bytes)
+        {
+            auto event = reinterpret_cast<inotify_event*>(&buffer[offset]);
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                overflow = true;
+            }
+            else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) &&
+                     !(event->mask & IN_ISDIR))
+            {
+                auto parent = watch->wds.find(event->wd);
+                if (parent != watch->wds.end() && event->len > 0 &&
+                    !isStagingFile(event->name))
+                {
+                    watch->queueImage(parent->second + '/' + event->name);
+                }
+            }
+            offset += offsetof(inotify_event, name) + event->len;
+        }
+    }
+
+    if (overflow)
+    {
+        log<level::WARNING>("inotify queue overflow, rescanning directories");
+        watch->rescan();
+    }
+    if (!watch->pendingImages.empty())
+    {
+        sd_event_source_set_enabled(watch->dispatchSource, SD_EVENT_ONESHOT);
     }
 
     return 0;
 }
 
+int Watch::dispatch(sd_event_source* /* s */, void* userdata)
+{
+    auto watch = static_cast<Watch*>(userdata);
+    std::vector<std::string> batch;
+    batch.swap(watch->pendingImages);
+    for (auto& imagePath : batch)
+    {
+        int rc = -1;
+        try
+        {
+            rc = watch->imageCallback(imagePath);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(e.what());
+        }
+        if (rc < 0)
+        {
+            log<level::ERR>("Error processing image",
+                            entry("IMAGE=%s", imagePath.c_str()));
+        }
+    }
+    return 0;
+}
+
+void Watch::addPath(const std::filesystem::path& path)
+{
+    for (const auto& [wd, watched] : wds)
+    {
+        if (watched == path.string())
+        {
+            return;
+        }
+    }
+    // Create Directory, images already staged in it are kept
+    std::filesystem::create_directories(path);
+    // Add to watch
+    auto wd = inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (-1 == wd)
+    {
+        auto error = errno;
+        throw std::runtime_error("inotify_add_watch failed, errno="s +
+                                 std::strerror(error));
+    }
+    wds[wd] = path;
+    // Pick up the images uploaded before the watch existed
+    scan(path);
+    if (!pendingImages.empty())
+    {
+        sd_event_source_set_enabled(dispatchSource, SD_EVENT_ONESHOT);
+    }
+}
+
+bool Watch::isStagingFile(const std::string& imagePath)
+{
+    constexpr std::string_view suffix = IMAGE_STAGING_SUFFIX;
+    return !suffix.empty() && imagePath.ends_with(suffix);
+}
+
+void Watch::queueImage(const std::string& imagePath)
+{
+    if (std::find(pendingImages.begin(), pendingImages.end(), imagePath) ==
+        pendingImages.end())
+    {
+        pendingImages.emplace_back(imagePath);
+    }
+}
+
+void Watch::rescan()
+{
+    for (const auto& [wd, path] : wds)
+    {
+        scan(path);
+    }
+}
+
+void Watch::scan(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(path, ec))
+    {
+        if (file.is_regular_file(ec) && !isStagingFile(file.path().filename()))
+        {
+            queueImage(file.path().string());
+        }
+    }
+    if (ec)
+    {
+        log<level::ERR>("Unable to scan upload directory",
+                        entry("PATH=%s", path.c_str()),
+                        entry("ERROR=%s", ec.message().c_str()));
+    }
+}
+
 } // namespace updater
 } // namespace software
 } // namespace nvidia
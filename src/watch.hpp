@@ -31,6 +31,7 @@
 #include <functional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace nvidia
 {
@@ -45,6 +46,13 @@ namespace updater
  *
  *  The inotify watch is hooked up with sd-event, so that on call back,
  *  appropriate actions related to a software image upload can be taken.
+ *  Events are coalesced, the inotify fd is drained completely and the
+ *  uploaded images are handed to the image callback in one batch from a
+ *  deferred event source.
+ *
+ *  An image is picked up when it is closed after writing or renamed into
+ *  the directory. Uploaders can write to a name ending with the staging
+ *  suffix and rename it once complete, staging files are never processed.
  */
 class Watch
 {
@@ -52,6 +60,7 @@ class Watch
     /** @brief ctor - hook inotify watch with sd-event
      *
      *  @param[in] loop - sd-event object
+     *  @param[in] pathsToMonitor - upload directories, emptied and created
      *  @param[in] imageCallback - The callback function for processing
      *                             the image
      */
@@ -67,6 +76,21 @@ class Watch
      */
     ~Watch();
 
+    /** @brief Start watching an upload directory at runtime. The directory
+     *         is created if missing and the images already in it are
+     *         processed, nothing happens if it is watched already
+     *
+     *  @param[in] path - upload directory
+     */
+    void addPath(const std::filesystem::path& path);
+
+    /** @brief Check if the path is a partial upload
+     *
+     *  @param[in] imagePath - path or file name of the image
+     *  @returns true if the name ends with the staging suffix
+     */
+    static bool isStagingFile(const std::string& imagePath);
+
     /** @brief image upload directory watch descriptor */
     // int wd = -1;
     std::map<int, std::string> wds;
@@ -83,9 +107,41 @@ class Watch
     static int callback(sd_event_source* s, int fd, uint32_t revents,
                         void* userdata);
 
+    /** @brief sd-event callback of the deferred source, hands the pending
+     *         images to the image callback
+     *
+     *  @param[in] s - deferred event source
+     *  @param[in] userdata - pointer to Watch object
+     *  @returns 0
+     */
+    static int dispatch(sd_event_source* s, void* userdata);
+
+    /** @brief Queue an image for the next batch, once per path
+     *
+     *  @param[in] imagePath - path of the uploaded image
+     */
+    void queueImage(const std::string& imagePath);
+
+    /** @brief Queue every file of the watched directories, used when the
+     *         inotify queue overflowed and events were lost
+     */
+    void rescan();
+
+    /** @brief Queue every file of one directory
+     *
+     *  @param[in] path - watched directory
+     */
+    void scan(const std::filesystem::path& path);
+
     /** @brief inotify file descriptor */
     int fd = -1;
 
+    /** @brief deferred event source dispatching the pending images */
+    sd_event_source* dispatchSource = nullptr;
+
+    /** @brief images waiting for dispatch, in arrival order */
+    std::vector<std::string> pendingImages;
+
     /** @brief The callback function for processing the image. */
     std::function<int(std::string&)> imageCallback;
 };
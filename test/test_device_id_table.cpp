@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/device_id_table.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace nvidia::software::updater;
+
+class TestDeviceIdTable : public testing::Test
+{
+  public:
+    TestDeviceIdTable()
+    {
+        table.insert("uuid-b", "ModelA", "Vendor");
+        table.insert("uuid-a", "ModelB", "Vendor");
+    }
+
+    DeviceIdTable table;
+};
+
+TEST_F(TestDeviceIdTable, GetUUIDOfKnownModel)
+{
+    EXPECT_EQ(table.getUUID("ModelA", "Vendor"), "uuid-b");
+    EXPECT_EQ(table.getUUID("ModelB", "Vendor"), "uuid-a");
+}
+
+TEST_F(TestDeviceIdTable, GetUUIDPrefersGreatestOfModel)
+{
+    table.insert("uuid-c", "ModelA", "Vendor");
+    EXPECT_EQ(table.getUUID("ModelA", "Vendor"), "uuid-c");
+}
+
+TEST_F(TestDeviceIdTable, GetUUIDFallsBackToFirstUUID)
+{
+    // a model mismatch still resolves so that the update is possible
+    EXPECT_EQ(table.getUUID("Unknown", "Vendor"), "uuid-a");
+    EXPECT_EQ(table.getUUID("ModelA", "Other"), "uuid-a");
+}
+
+TEST_F(TestDeviceIdTable, GetUUIDOfEmptyTable)
+{
+    DeviceIdTable empty;
+    EXPECT_EQ(empty.getUUID("ModelA", "Vendor"), "");
+}
+
+TEST_F(TestDeviceIdTable, InsertKeepsKnownUUID)
+{
+    EXPECT_FALSE(table.insert("uuid-a", "ModelC", "Vendor"));
+    ASSERT_NE(table.find("uuid-a"), nullptr);
+    EXPECT_EQ(table.find("uuid-a")->model, "ModelB");
+}
+
+TEST_F(TestDeviceIdTable, EraseDropsIndexes)
+{
+    table.setDeviceId("ModelB", "Vendor", "3");
+    EXPECT_EQ(table.findUUIDByDeviceId("3"), "uuid-a");
+    EXPECT_TRUE(table.erase("uuid-a"));
+    EXPECT_FALSE(table.erase("uuid-a"));
+    EXPECT_FALSE(table.contains("uuid-a"));
+    EXPECT_EQ(table.findUUIDByDeviceId("3"), "");
+    EXPECT_EQ(table.getUUID("ModelB", "Vendor"), "uuid-b");
+}
+
+TEST_F(TestDeviceIdTable, SetDeviceIdReplacesPreviousId)
+{
+    table.setDeviceId("ModelA", "Vendor", "1");
+    table.setDeviceId("ModelA", "Vendor", "2");
+    EXPECT_EQ(table.findUUIDByDeviceId("1"), "");
+    EXPECT_EQ(table.findUUIDByDeviceId("2"), "uuid-b");
+    EXPECT_EQ(table.find("uuid-b")->deviceId, "2");
+}
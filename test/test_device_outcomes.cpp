@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/device_outcomes.hpp"
+
+#include <sdbusplus/test/sdbus_mock.hpp>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace nvidia::software::updater;
+
+class TestDeviceOutcomes : public testing::Test
+{
+  public:
+    TestDeviceOutcomes() :
+        bus(sdbusplus::get_mocked_new(&sdbusMock)),
+        outcomes(bus, "/xyz/openbmc_project/software/test")
+    {}
+
+    testing::NiceMock<sdbusplus::SdBusMock> sdbusMock;
+    sdbusplus::bus::bus bus;
+    DeviceOutcomes outcomes;
+};
+
+TEST_F(TestDeviceOutcomes, UnknownDevice)
+{
+    EXPECT_FALSE(outcomes.get("dev0"));
+    EXPECT_EQ(outcomes.getAttempts("dev0"), 0u);
+}
+
+TEST_F(TestDeviceOutcomes, SetAndFind)
+{
+    outcomes.set("dev0", DeviceOutcome::Queued);
+    outcomes.set("dev1", DeviceOutcome::Skipped);
+    outcomes.set("dev2", DeviceOutcome::Queued);
+    EXPECT_EQ(outcomes.get("dev1"), DeviceOutcome::Skipped);
+    EXPECT_THAT(outcomes.find(DeviceOutcome::Queued),
+                testing::ElementsAre("dev0", "dev2"));
+    EXPECT_TRUE(outcomes.find(DeviceOutcome::Failed).empty());
+}
+
+TEST_F(TestDeviceOutcomes, AttemptsCount)
+{
+    outcomes.set("dev0", DeviceOutcome::Queued);
+    outcomes.addAttempt("dev0");
+    EXPECT_EQ(outcomes.get("dev0"), DeviceOutcome::Updating);
+    outcomes.set("dev0", DeviceOutcome::Retrying);
+    outcomes.addAttempt("dev0");
+    EXPECT_EQ(outcomes.getAttempts("dev0"), 2u);
+}
+
+TEST_F(TestDeviceOutcomes, AnyFailed)
+{
+    outcomes.set("dev0", DeviceOutcome::Updated);
+    EXPECT_FALSE(outcomes.anyFailed());
+    outcomes.set("dev1", DeviceOutcome::Failed);
+    EXPECT_TRUE(outcomes.anyFailed());
+}
+
+TEST_F(TestDeviceOutcomes, ResumeKeepsUpdatedDevices)
+{
+    outcomes.set("dev0", DeviceOutcome::Updated);
+    outcomes.addAttempt("dev1");
+    outcomes.set("dev1", DeviceOutcome::Failed);
+    outcomes.set("dev2", DeviceOutcome::Skipped);
+    outcomes.resume();
+    EXPECT_EQ(outcomes.get("dev0"), DeviceOutcome::Updated);
+    EXPECT_FALSE(outcomes.get("dev1"));
+    EXPECT_EQ(outcomes.getAttempts("dev1"), 0u);
+    EXPECT_FALSE(outcomes.get("dev2"));
+    EXPECT_FALSE(outcomes.anyFailed());
+}
+
+TEST_F(TestDeviceOutcomes, Erase)
+{
+    outcomes.set("dev0", DeviceOutcome::Updated);
+    outcomes.addAttempt("dev1");
+    outcomes.erase("dev0");
+    outcomes.erase("dev2");
+    EXPECT_FALSE(outcomes.get("dev0"));
+    EXPECT_EQ(outcomes.get("dev1"), DeviceOutcome::Updating);
+}
+
+TEST_F(TestDeviceOutcomes, Clear)
+{
+    outcomes.set("dev0", DeviceOutcome::Updated);
+    outcomes.clear();
+    EXPECT_FALSE(outcomes.get("dev0"));
+}
+
+TEST_F(TestDeviceOutcomes, ToString)
+{
+    EXPECT_STREQ(DeviceOutcomes::toString(DeviceOutcome::Queued), "Queued");
+    EXPECT_STREQ(DeviceOutcomes::toString(DeviceOutcome::Updating),
+                 "Updating");
+    EXPECT_STREQ(DeviceOutcomes::toString(DeviceOutcome::Retrying),
+                 "Retrying");
+    EXPECT_STREQ(DeviceOutcomes::toString(DeviceOutcome::Updated), "Updated");
+    EXPECT_STREQ(DeviceOutcomes::toString(DeviceOutcome::Failed), "Failed");
+    EXPECT_STREQ(DeviceOutcomes::toString(DeviceOutcome::Skipped), "Skipped");
+}
@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/flash_history.hpp"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace nvidia::software::updater;
+using std::chrono::seconds;
+
+class TestFlashHistory : public testing::Test
+{
+  public:
+    TestFlashHistory() :
+        file(std::filesystem::temp_directory_path() /
+             ("flash_history_" + std::to_string(getpid()) + ".json")),
+        history(file)
+    {}
+
+    ~TestFlashHistory()
+    {
+        std::filesystem::remove(file);
+    }
+
+    std::filesystem::path file;
+    FlashHistory history;
+    const std::string key = FlashHistory::makeKey("ModelA", 1);
+};
+
+TEST_F(TestFlashHistory, MakeKeyRoundsUpToMiB)
+{
+    constexpr uintmax_t mib = 1024 * 1024;
+    EXPECT_EQ(FlashHistory::makeKey("ModelA", 0), "ModelA:0");
+    EXPECT_EQ(FlashHistory::makeKey("ModelA", 1), "ModelA:1");
+    EXPECT_EQ(FlashHistory::makeKey("ModelA", mib), "ModelA:1");
+    EXPECT_EQ(FlashHistory::makeKey("ModelA", mib + 1), "ModelA:2");
+}
+
+TEST_F(TestFlashHistory, PercentileOfEmptyHistory)
+{
+    EXPECT_FALSE(history.percentile(key, 95));
+}
+
+TEST_F(TestFlashHistory, PercentileNearestRank)
+{
+    for (int i = 1; i <= 10; i++)
+    {
+        history.add(key, seconds(i * 10));
+    }
+    EXPECT_EQ(history.percentile(key, 0), seconds(10));
+    EXPECT_EQ(history.percentile(key, 50), seconds(50));
+    EXPECT_EQ(history.percentile(key, 95), seconds(100));
+    EXPECT_EQ(history.percentile(key, 100), seconds(100));
+    EXPECT_EQ(history.percentile(key, 200), seconds(100));
+}
+
+TEST_F(TestFlashHistory, KeepsLastSamples)
+{
+    for (size_t i = 1; i <= FlashHistory::maxSamples + 8; i++)
+    {
+        history.add(key, seconds(i));
+    }
+    EXPECT_EQ(history.size(key), FlashHistory::maxSamples);
+    EXPECT_EQ(history.percentile(key, 0), seconds(9));
+}
+
+TEST_F(TestFlashHistory, NegativeDurationCountsAsZero)
+{
+    history.add(key, seconds(-5));
+    EXPECT_EQ(history.percentile(key, 50), seconds(0));
+}
+
+TEST_F(TestFlashHistory, TimeoutNeedsMinSamples)
+{
+    for (size_t i = 1; i < FlashHistory::minSamples; i++)
+    {
+        history.add(key, seconds(100));
+    }
+    EXPECT_EQ(history.getTimeout(key, 1200), 1200u);
+    history.add(key, seconds(100));
+    // half again the 95th percentile plus a margin of a minute
+    EXPECT_EQ(history.getTimeout(key, 1200), 210u);
+}
+
+TEST_F(TestFlashHistory, TimeoutNeverExceedsConfigured)
+{
+    for (size_t i = 0; i < FlashHistory::minSamples; i++)
+    {
+        history.add(key, seconds(1000));
+    }
+    EXPECT_EQ(history.getTimeout(key, 1200), 1200u);
+}
+
+TEST_F(TestFlashHistory, KeysAreIndependent)
+{
+    for (size_t i = 0; i < FlashHistory::minSamples; i++)
+    {
+        history.add(key, seconds(100));
+    }
+    auto other = FlashHistory::makeKey("ModelB", 1);
+    EXPECT_EQ(history.size(other), 0u);
+    EXPECT_EQ(history.getTimeout(other, 1200), 1200u);
+}
+
+TEST_F(TestFlashHistory, SaveAndLoad)
+{
+    history.add(key, seconds(30));
+    history.add(key, seconds(40));
+    history.save();
+
+    FlashHistory loaded(file);
+    loaded.load();
+    EXPECT_EQ(loaded.size(key), 2u);
+    EXPECT_EQ(loaded.percentile(key, 100), seconds(40));
+}
+
+TEST_F(TestFlashHistory, LoadIgnoresCorruptFile)
+{
+    {
+        std::ofstream out(file);
+        out << "{ not json";
+    }
+    history.add(key, seconds(30));
+    history.load();
+    EXPECT_EQ(history.size(key), 0u);
+}
+
+TEST_F(TestFlashHistory, LoadIgnoresOtherSchema)
+{
+    {
+        std::ofstream out(file);
+        out << R"({"schema": 1, "durations": [10, 20, 30]})";
+    }
+    history.load();
+    EXPECT_EQ(history.size(key), 0u);
+}
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/image_digest.hpp"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace nvidia::software::updater;
+
+class TestImageDigest : public testing::Test
+{
+  public:
+    TestImageDigest() :
+        file(std::filesystem::temp_directory_path() /
+             ("image_digest_" + std::to_string(getpid()) + ".bin"))
+    {}
+
+    ~TestImageDigest()
+    {
+        std::filesystem::remove(file);
+    }
+
+    void writeImage(const std::string& content)
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+    std::filesystem::path file;
+};
+
+TEST_F(TestImageDigest, Sha256)
+{
+    writeImage("abc");
+    EXPECT_EQ(
+        computeImageDigest(file, "SHA256"),
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST_F(TestImageDigest, Sha512)
+{
+    writeImage("abc");
+    EXPECT_EQ(computeImageDigest(file, "SHA512"),
+              "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+              "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+}
+
+TEST_F(TestImageDigest, EmptyImage)
+{
+    writeImage("");
+    EXPECT_EQ(
+        computeImageDigest(file, "SHA256"),
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+TEST_F(TestImageDigest, MissingImage)
+{
+    EXPECT_EQ(computeImageDigest(file, "SHA256"), "");
+}
+
+TEST_F(TestImageDigest, UnknownAlgorithm)
+{
+    writeImage("abc");
+    EXPECT_EQ(computeImageDigest(file, "NOSUCHDIGEST"), "");
+}
+
+TEST_F(TestImageDigest, DigestInSteps)
+{
+    constexpr size_t mib = 1024 * 1024;
+    writeImage(std::string(3 * mib, 'x'));
+    ImageDigester digester(file, "SHA256");
+    EXPECT_FALSE(digester.update(mib));
+    EXPECT_TRUE(digester.result().empty());
+    EXPECT_FALSE(digester.update(mib));
+    EXPECT_TRUE(digester.update(mib));
+    EXPECT_EQ(digester.result(), computeImageDigest(file, "SHA256"));
+    // complete digests are not updated again
+    EXPECT_TRUE(digester.update(mib));
+}
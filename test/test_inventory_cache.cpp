@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/inventory_cache.hpp"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace nvidia::software::updater;
+
+class TestInventoryCache : public testing::Test
+{
+  public:
+    TestInventoryCache() :
+        file(std::filesystem::temp_directory_path() /
+             ("inventory_cache_" + std::to_string(getpid()) + ".json")),
+        cache(file)
+    {}
+
+    ~TestInventoryCache()
+    {
+        std::filesystem::remove(file);
+    }
+
+    std::filesystem::path file;
+    InventoryCache cache;
+    const std::string device = "/xyz/openbmc_project/inventory/system/dev0";
+    const InventoryCache::Entry entry{"1.2.3", "ModelA", "Vendor", "uuid-a",
+                                      "", ""};
+};
+
+TEST_F(TestInventoryCache, FindUnknownDevice)
+{
+    EXPECT_FALSE(cache.find(device));
+}
+
+TEST_F(TestInventoryCache, UpdateReportsChanges)
+{
+    EXPECT_TRUE(cache.update(device, entry));
+    auto stored = cache.find(device);
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(stored->version, "1.2.3");
+    EXPECT_NE(stored->stamp, 0u);
+
+    EXPECT_FALSE(cache.update(device, entry));
+
+    auto changed = entry;
+    changed.version = "1.2.4";
+    EXPECT_TRUE(cache.update(device, changed));
+    EXPECT_EQ(cache.find(device)->version, "1.2.4");
+}
+
+TEST_F(TestInventoryCache, RetainDropsMissingDevices)
+{
+    cache.update(device, entry);
+    cache.update(device + "1", entry);
+    EXPECT_FALSE(cache.retain({device, device + "1"}));
+    EXPECT_TRUE(cache.retain({device}));
+    EXPECT_EQ(cache.getEntries().size(), 1u);
+    EXPECT_TRUE(cache.find(device));
+}
+
+TEST_F(TestInventoryCache, SaveAndLoad)
+{
+    cache.update(device, entry);
+    cache.save();
+
+    InventoryCache loaded(file);
+    loaded.load();
+    auto stored = loaded.find(device);
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(stored->version, entry.version);
+    EXPECT_EQ(stored->model, entry.model);
+    EXPECT_EQ(stored->manufacturer, entry.manufacturer);
+    EXPECT_EQ(stored->uuid, entry.uuid);
+    EXPECT_EQ(stored->stamp, cache.find(device)->stamp);
+}
+
+TEST_F(TestInventoryCache, FlashedDigest)
+{
+    EXPECT_FALSE(cache.setFlashedDigest(device, "abc"));
+    cache.update(device, entry);
+    EXPECT_TRUE(cache.setFlashedDigest(device, "abc"));
+    EXPECT_FALSE(cache.setFlashedDigest(device, "abc"));
+    EXPECT_EQ(cache.find(device)->flashedDigest, "abc");
+    EXPECT_TRUE(cache.find(device)->flashedVersion.empty());
+
+    // The version read after the flash is recorded by the next update
+    auto flashed = entry;
+    flashed.flashedDigest = "abc";
+    flashed.flashedVersion = "1.2.3";
+    EXPECT_TRUE(cache.update(device, flashed));
+    cache.save();
+
+    InventoryCache loaded(file);
+    loaded.load();
+    auto stored = loaded.find(device);
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(stored->flashedDigest, "abc");
+    EXPECT_EQ(stored->flashedVersion, "1.2.3");
+
+    EXPECT_TRUE(cache.setFlashedDigest(device, ""));
+    EXPECT_TRUE(cache.find(device)->flashedDigest.empty());
+}
+
+TEST_F(TestInventoryCache, LoadSkipsEntriesWithoutVersion)
+{
+    {
+        std::ofstream out(file);
+        out << R"({"schema": 1, "entries": {"/a": {"model": "M"},)"
+            << R"( "/b": {"version": "2"}}})";
+    }
+    cache.load();
+    EXPECT_FALSE(cache.find("/a"));
+    EXPECT_TRUE(cache.find("/b"));
+}
+
+TEST_F(TestInventoryCache, LoadIgnoresOtherSchema)
+{
+    {
+        std::ofstream out(file);
+        out << R"({"schema": 0, "entries": {"/b": {"version": "2"}}})";
+    }
+    cache.update(device, entry);
+    cache.load();
+    EXPECT_TRUE(cache.getEntries().empty());
+}
+
+TEST_F(TestInventoryCache, LoadIgnoresCorruptFile)
+{
+    {
+        std::ofstream out(file);
+        out << "{ not json";
+    }
+    cache.load();
+    EXPECT_TRUE(cache.getEntries().empty());
+}
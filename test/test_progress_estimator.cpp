@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/progress_estimator.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace nvidia::software::updater;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+class TestProgressEstimator : public testing::Test
+{
+  public:
+    ProgressEstimator estimator;
+    ProgressEstimator::Clock::time_point t0{};
+};
+
+TEST_F(TestProgressEstimator, NoDevicesIsDone)
+{
+    estimator.start(0, t0);
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 1.0);
+}
+
+TEST_F(TestProgressEstimator, FractionCombinesDevices)
+{
+    estimator.start(2, t0);
+    estimator.update("a", 0.5, t0 + seconds(1));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.25);
+    estimator.done("a", t0 + seconds(2));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.5);
+    estimator.update("b", 0.5, t0 + seconds(3));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.75);
+}
+
+TEST_F(TestProgressEstimator, ProgressNeverGoesBack)
+{
+    estimator.start(1, t0);
+    estimator.update("a", 0.6, t0 + seconds(1));
+    estimator.update("a", 0.2, t0 + seconds(2));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.6);
+    estimator.update("a", 7, t0 + seconds(3));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 1.0);
+}
+
+TEST_F(TestProgressEstimator, DoneIsCappedByDevices)
+{
+    estimator.start(1, t0);
+    estimator.done("a", t0 + seconds(1));
+    estimator.done("b", t0 + seconds(2));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 1.0);
+}
+
+TEST_F(TestProgressEstimator, FailedAttemptStartsOver)
+{
+    estimator.start(2, t0);
+    estimator.update("a", 0.8, t0 + seconds(1));
+    estimator.update("b", 0.4, t0 + seconds(1));
+    estimator.failed("a", t0 + seconds(2));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.2);
+    // the retry is not held at the progress of the failed attempt
+    estimator.update("a", 0.1, t0 + seconds(3));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.25);
+    estimator.done("a", t0 + seconds(4));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.7);
+}
+
+TEST_F(TestProgressEstimator, RemainingUnknownWithoutRate)
+{
+    estimator.start(1, t0);
+    EXPECT_FALSE(estimator.getRemaining(t0 + seconds(1)));
+    // samples closer than half a second are merged
+    estimator.update("a", 0.5, t0 + milliseconds(100));
+    EXPECT_FALSE(estimator.getRemaining(t0 + seconds(1)));
+}
+
+TEST_F(TestProgressEstimator, RemainingFromRate)
+{
+    estimator.start(1, t0);
+    estimator.update("a", 0.1, t0 + seconds(10));
+    EXPECT_EQ(estimator.getRemaining(t0 + seconds(10)), seconds(90));
+    // time passed since the last sample is taken off
+    EXPECT_EQ(estimator.getRemaining(t0 + seconds(30)), seconds(70));
+    EXPECT_EQ(estimator.getRemaining(t0 + seconds(200)), seconds(0));
+}
+
+TEST_F(TestProgressEstimator, RateIsSmoothed)
+{
+    estimator.start(1, t0);
+    estimator.update("a", 0.1, t0 + seconds(10));
+    estimator.update("a", 0.4, t0 + seconds(20));
+    // 0.2 * 0.03 + 0.8 * 0.01 per second, 0.6 left
+    EXPECT_EQ(estimator.getRemaining(t0 + seconds(20)), seconds(43));
+}
+
+TEST_F(TestProgressEstimator, StartResets)
+{
+    estimator.start(1, t0);
+    estimator.update("a", 0.5, t0 + seconds(10));
+    estimator.start(2, t0 + seconds(20));
+    EXPECT_DOUBLE_EQ(estimator.getFraction(), 0.0);
+    EXPECT_FALSE(estimator.getRemaining(t0 + seconds(20)));
+}
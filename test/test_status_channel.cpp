@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/status_channel.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace nvidia::software::updater;
+
+TEST(TestStatusChannel, ParsePercent)
+{
+    auto progress = StatusChannel::parseProgress("PROGRESS 40");
+    ASSERT_TRUE(progress);
+    EXPECT_DOUBLE_EQ(*progress, 0.4);
+}
+
+TEST(TestStatusChannel, ParseDoneOfTotal)
+{
+    auto progress = StatusChannel::parseProgress("PROGRESS 512 2048");
+    ASSERT_TRUE(progress);
+    EXPECT_DOUBLE_EQ(*progress, 0.25);
+}
+
+TEST(TestStatusChannel, ParseCapsAtDone)
+{
+    auto progress = StatusChannel::parseProgress("PROGRESS 150");
+    ASSERT_TRUE(progress);
+    EXPECT_DOUBLE_EQ(*progress, 1.0);
+}
+
+TEST(TestStatusChannel, ParseRejectsOtherLines)
+{
+    // heartbeats and malformed reports carry no progress
+    EXPECT_FALSE(StatusChannel::parseProgress(""));
+    EXPECT_FALSE(StatusChannel::parseProgress("ALIVE"));
+    EXPECT_FALSE(StatusChannel::parseProgress("PROGRESS"));
+    EXPECT_FALSE(StatusChannel::parseProgress("PROGRESS abc"));
+    EXPECT_FALSE(StatusChannel::parseProgress("progress 10"));
+    EXPECT_FALSE(StatusChannel::parseProgress("PROGRESS 10 0"));
+}